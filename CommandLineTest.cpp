@@ -1,11 +1,21 @@
 #include "MemoryManager/MemoryManager.h"
+#include "MemoryManager/ConcurrentMemoryManager.h"
+#include "MemoryManager/SlabAllocator.h"
+#include "MemoryManager/BasicMemoryManager.h"
+#include "MemoryManager/GrowableMemoryManager.h"
+#include "MemoryManager/NumaMemoryManager.h"
+#include "MemoryManager/ArenaAllocator.h"
+#include "MemoryManager/SharedMemoryManager.h"
 #include <string>
 #include <cmath>
 #include <array>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <vector>
 #include <iostream>
+#include <thread>
+#include <sys/wait.h>
 
 
 
@@ -20,6 +30,33 @@ unsigned int testRepeatedShutdown();
 unsigned int testMaxInitialization();
 unsigned int testGetters();
 unsigned int testReadingUsingGetMemoryStart();
+unsigned int testFitStrategy();
+unsigned int testMergeBothNeighbours();
+unsigned int testWideInitialization();
+unsigned int testMmapBackingStore();
+unsigned int testBitmapNextFit();
+unsigned int testConcurrentAllocate();
+unsigned int testSlabAllocator();
+unsigned int testBatchAllocate();
+unsigned int testBasicMemoryManager();
+unsigned int testBuddyEngine();
+unsigned int testTlsfEngine();
+unsigned int testCompaction();
+unsigned int testRegions();
+unsigned int testReallocate();
+unsigned int testGrowableMemoryManager();
+unsigned int testRemoteFree();
+unsigned int testNumaMemoryManager();
+unsigned int testAllocatorStats();
+unsigned int testBinaryMemoryMap();
+unsigned int testAllocationSampling();
+unsigned int testAlignedAllocation();
+unsigned int testAllocationHints();
+unsigned int testPagePurge();
+unsigned int testPersistentArena();
+unsigned int testSharedMemoryManager();
+unsigned int testHardenedBuild();
+unsigned int testHoleListView();
 
 
 // helper functions
@@ -29,6 +66,10 @@ unsigned int testGetList(MemoryManager& memoryManager, uint16_t correctListLengt
 unsigned int testGetWordSize(MemoryManager& memoryManager, size_t correctWordSize);
 unsigned int testGetMemoryLimit(MemoryManager& memoryManager, size_t correctMemoryLimit);
 unsigned int testDumpMemoryMap(MemoryManager& memoryManager, std::string fileName, std::string correctFileContents);
+size_t blockWords(MemoryManager& memoryManager, size_t sizeInWords);
+template <typename Offset>
+std::vector<uint8_t> bitmapOf(size_t numberOfWords, const std::vector<Offset>& holes);
+void* allocateThrough(MemoryManager& memoryManager, unsigned int entryPoint);
 
 int hopesAndDreamsAllocator(int sizeInWords, void* list)
 {
@@ -78,7 +119,7 @@ int hopesAndDreamsAllocator(int sizeInWords, void* list)
 
 int main()
 {
-    unsigned int maxScore = 38;
+    unsigned int maxScore = 120;
     unsigned int score = 0;
     
     score += testMemoryLeaksNoShutdown(); // 0
@@ -108,8 +149,90 @@ int main()
     std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
     
     score += 5 * testReadingUsingGetMemoryStart(); // 1 * 5
-    
     std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testFitStrategy(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testMergeBothNeighbours(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testWideInitialization(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testMmapBackingStore(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testBitmapNextFit(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testConcurrentAllocate(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testSlabAllocator(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testBatchAllocate(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testBasicMemoryManager(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testBuddyEngine(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testTlsfEngine(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testCompaction(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testRegions(); // 5
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testReallocate(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testGrowableMemoryManager(); // 4
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testRemoteFree(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testNumaMemoryManager(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testAllocatorStats(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testBinaryMemoryMap(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testAllocationSampling(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testAlignedAllocation(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testAllocationHints(); // 3
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testPagePurge(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testPersistentArena(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testSharedMemoryManager(); // 2
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testHardenedBuild(); // 5
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+
+    score += testHoleListView(); // 2
+
+    std::cout << "Score: " << score << " / " <<  maxScore << std::endl;
+    return score == maxScore ? 0 : 1;
 }
 
 
@@ -143,9 +266,14 @@ unsigned int testSimpleFirstFit()
     std::cout << "Test Case: First Fit 1" << std::endl;
 
     unsigned int  wordSize = 8;
-    size_t numberOfWords = 26;
     MemoryManager memoryManager(wordSize, bestFit);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t words6 = blockWords(memoryManager, 6);
+    uint16_t used = words10 + words2 + words2 + words6;
+    size_t numberOfWords = used + 6;
     memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
 
     std::cout << "allocating and freeing memory..." << std::endl;
 
@@ -157,12 +285,12 @@ unsigned int testSimpleFirstFit()
     memoryManager.free(testArray1);
     memoryManager.free(testArray3);
 
-    std::vector<uint8_t> correctBitmap{0x00,0xCC,0x0F,0x00};
-    uint16_t correctBitmapLength = correctBitmap.size();
-
-    std::vector<uint16_t> correctList = {0, 10, 12, 2, 20, 6};
+    std::vector<uint16_t> correctList = {0, words10, static_cast<uint16_t>(words10 + words2), words2, used, 6};
     uint16_t correctListLength = correctList.size() * 2;
 
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, correctList);
+    uint16_t correctBitmapLength = correctBitmap.size();
+
     std::cout << "Testing Memory Manager state after allocations and frees" << std::endl;
 
 
@@ -181,9 +309,13 @@ unsigned int testSimpleBestFit()
 {
     std::cout << "Test Case: Best Fit 1" << std::endl;
     unsigned int wordSize = 4;
-    size_t numberOfWords = 96;
     MemoryManager memoryManager(wordSize, worstFit);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t words5 = blockWords(memoryManager, 5);
+    uint16_t used = 4 * words2 + 2 * words5;
+    size_t numberOfWords = used + 78;
     memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
     // allocate
     uint32_t* testArray1 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 2));
     uint32_t* testArray2 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 2));
@@ -204,11 +336,11 @@ unsigned int testSimpleBestFit()
     uint32_t* testArray7 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 2));
 
 
-    std::vector<uint8_t> correctBitmap{0x0F, 0xFE, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctList = {4,5,18,78};
+    std::vector<uint16_t> correctList = {static_cast<uint16_t>(2 * words2), words5, used, 78};
     uint16_t correctListLength = correctList.size() * 2;
 
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, correctList);
+
     std::string correctFileContents = vectorToString(correctList);
 
     unsigned int score = 0;
@@ -229,9 +361,16 @@ unsigned int testComplexBestFit()
 {
     std::cout << "Test Case: Best Fit 2" << std::endl;
     unsigned int wordSize = 4;
-    size_t numberOfWords = 96;
     MemoryManager memoryManager(wordSize, worstFit);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t words4 = blockWords(memoryManager, 4);
+    uint16_t words3 = blockWords(memoryManager, 3);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t words1 = blockWords(memoryManager, 1);
+    uint16_t used = 5 * words10 + words4 + words3 + words2 + words1;
+    size_t numberOfWords = used + 36;
     memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
 
     uint32_t* testArray1 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 10));
     uint32_t* testArray2 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 4));
@@ -243,14 +382,19 @@ unsigned int testComplexBestFit()
     uint32_t* testArray8 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 1));
     uint32_t* testArray9 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 10));
 
+    // where the 2nd, 4th, 6th & 8th blocks start
+    uint16_t offset2 = words10;
+    uint16_t offset4 = offset2 + words4 + words10;
+    uint16_t offset6 = offset4 + words3 + words10;
+    uint16_t offset8 = offset6 + words2 + words10;
 
     unsigned int score = 0;
 
-    std::vector<uint8_t> correctBitmapBeforeFree{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListBeforeFree = {60, 36};
+    std::vector<uint16_t> correctListBeforeFree = {used, 36};
     uint16_t correctListLengthBeforeFree = correctListBeforeFree.size() * 2;
 
+    std::vector<uint8_t> correctBitmapBeforeFree = bitmapOf(numberOfWords, correctListBeforeFree);
+
     std::cout << "Testing Memory Manager state after initial allocations" << std::endl;
 
     score += testGetBitmap(memoryManager, correctBitmapBeforeFree.size(), correctBitmapBeforeFree);
@@ -264,11 +408,11 @@ unsigned int testComplexBestFit()
     memoryManager.free(testArray6);
     memoryManager.free(testArray8);
 
-    std::vector<uint8_t> correctBitmapAfterFree{0xFF, 0xC3, 0xFF, 0xF8, 0x9F, 0xFF, 0xFD, 0x0F, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfterFree = {10, 4, 24, 3, 37, 2, 49, 1, 60, 36};
+    std::vector<uint16_t> correctListAfterFree = {offset2, words4, offset4, words3, offset6, words2, offset8, words1, used, 36};
     uint16_t correctListLengthAfterFree = correctListAfterFree.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfterFree = bitmapOf(numberOfWords, correctListAfterFree);
+
     std::cout << "Testing Memory Manager state after freeing specific areas " << std::endl;
 
 
@@ -284,11 +428,11 @@ unsigned int testComplexBestFit()
 
     uint32_t* testArray10 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 1));
 
-    std::vector<uint8_t> correctBitmapAfter1{0xFF, 0xC3, 0xFF, 0xF8, 0x9F, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter1 = {10, 4, 24, 3, 37, 2, 60, 36};
+    std::vector<uint16_t> correctListAfter1 = {offset2, words4, offset4, words3, offset6, words2, used, 36};
     uint16_t correctListLengthAfter1 = correctListAfter1.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter1 = bitmapOf(numberOfWords, correctListAfter1);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
 
@@ -300,11 +444,11 @@ unsigned int testComplexBestFit()
 
     uint32_t* testArray11 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 2));
 
-    std::vector<uint8_t> correctBitmapAfter2{0xFF, 0xC3, 0xFF, 0xF8, 0xFF, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter2 = {10, 4, 24, 3, 60, 36};
+    std::vector<uint16_t> correctListAfter2 = {offset2, words4, offset4, words3, used, 36};
     uint16_t correctListLengthAfter2 = correctListAfter2.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter2 = bitmapOf(numberOfWords, correctListAfter2);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
 
@@ -316,11 +460,11 @@ unsigned int testComplexBestFit()
 
     uint32_t* testArray12 = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 3));
 
-    std::vector<uint8_t> correctBitmapAfter3{0xFF, 0xC3, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter3 = {10, 4, 60, 36};
+    std::vector<uint16_t> correctListAfter3 = {offset2, words4, used, 36};
     uint16_t correctListLengthAfter3 = correctListAfter3.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter3 = bitmapOf(numberOfWords, correctListAfter3);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
 
@@ -332,11 +476,11 @@ unsigned int testComplexBestFit()
     std::cout << "Allocating 4 words" <<std::endl;
 
 
-    std::vector<uint8_t> correctBitmapAfter4{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter4 = {60, 36};
+    std::vector<uint16_t> correctListAfter4 = {used, 36};
     uint16_t correctListLengthAfter4 = correctListAfter4.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter4 = bitmapOf(numberOfWords, correctListAfter4);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
 
@@ -354,9 +498,15 @@ unsigned int testNewAllocator()
 {
     std::cout << "Test Case: New allocator";
     unsigned int wordSize = 8;
-    size_t numberOfWords = 88;
     MemoryManager memoryManager(wordSize, worstFit);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t words13 = blockWords(memoryManager, 13);
+    uint16_t words8 = blockWords(memoryManager, 8);
+    uint16_t words4 = blockWords(memoryManager, 4);
+    uint16_t used = 4 * words10 + words13 + words8 + words4;
+    size_t numberOfWords = used + 23;
     memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
 
 
     uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
@@ -371,6 +521,11 @@ unsigned int testNewAllocator()
     memoryManager.free(testArray4);
     memoryManager.free(testArray6);
 
+    // where the 2nd, 4th & 6th blocks start
+    uint16_t offset2 = words10;
+    uint16_t offset4 = offset2 + words13 + words10;
+    uint16_t offset6 = offset4 + words8 + words10;
+
     unsigned int score = 0;
 
     memoryManager.setAllocator(hopesAndDreamsAllocator);
@@ -379,11 +534,11 @@ unsigned int testNewAllocator()
 
     uint64_t* testArray8 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 4));
 
-    std::vector<uint8_t> correctBitmapAfter1{0xFF, 0x03, 0x80, 0xFF, 0x01, 0xFE, 0x87, 0xFF, 0x1F, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter1 = {10, 13, 33, 8, 51, 4, 69, 19};
+    std::vector<uint16_t> correctListAfter1 = {offset2, words13, offset4, words8, offset6, words4, static_cast<uint16_t>(used + words4), static_cast<uint16_t>(23 - words4)};
     uint16_t correctListLengthAfter1 = correctListAfter1.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter1 = bitmapOf(numberOfWords, correctListAfter1);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
     score += testGetBitmap(memoryManager, correctBitmapAfter1.size(), correctBitmapAfter1);
@@ -394,11 +549,11 @@ unsigned int testNewAllocator()
 
     uint64_t* testArray9 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 4));
         
-    std::vector<uint8_t> correctBitmapAfter2{0xFF, 0x3F, 0x80, 0xFF, 0x01, 0xFE, 0x87, 0xFF, 0x1F, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter2 = {14, 9, 33, 8, 51, 4, 69, 19};
+    std::vector<uint16_t> correctListAfter2 = {static_cast<uint16_t>(offset2 + words4), static_cast<uint16_t>(words13 - words4), offset4, words8, offset6, words4, static_cast<uint16_t>(used + words4), static_cast<uint16_t>(23 - words4)};
     uint16_t correctListLengthAfter2 = correctListAfter2.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter2 = bitmapOf(numberOfWords, correctListAfter2);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
 
@@ -410,11 +565,11 @@ unsigned int testNewAllocator()
 
     uint64_t* testArray10 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 4));
 
-    std::vector<uint8_t> correctBitmapAfter3{0xFF, 0x3F, 0x80, 0xFF, 0x1F, 0xFE, 0x87, 0xFF, 0x1F, 0x00, 0x00};
-
-    std::vector<uint16_t> correctListAfter3 = {14, 9, 37, 4, 51, 4, 69, 19};
+    std::vector<uint16_t> correctListAfter3 = {static_cast<uint16_t>(offset2 + words4), static_cast<uint16_t>(words13 - words4), static_cast<uint16_t>(offset4 + words4), static_cast<uint16_t>(words8 - words4), offset6, words4, static_cast<uint16_t>(used + words4), static_cast<uint16_t>(23 - words4)};
     uint16_t correctListLengthAfter3 = correctListAfter3.size() * 2;
 
+    std::vector<uint8_t> correctBitmapAfter3 = bitmapOf(numberOfWords, correctListAfter3);
+
     std::cout << "Testing Memory Manager state\n" << std::endl;
 
 
@@ -433,14 +588,14 @@ unsigned int testInvalidAllocate()
 {
     std::cout << "Test Case: invalid allocation, over the allowed amount" << std::endl;
     unsigned int wordSize = 2;
-    size_t numberOfWords = 20;
     MemoryManager memoryManager(wordSize, worstFit);
+    size_t numberOfWords = blockWords(memoryManager, 20);
     memoryManager.initialize(numberOfWords);
 
-    uint16_t* testArray1 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * numberOfWords));
+    uint16_t* testArray1 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 20));
     uint16_t* testArray2 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 1));
 
-    if(testArray2 == nullptr) {
+    if(testArray1 != nullptr && testArray2 == nullptr) {
         std::cout << "[CORRECT]\n" << std::endl;
         return 1;
     }
@@ -455,9 +610,13 @@ unsigned int testRepeatedShutdown()
 {
     std::cout << "Test Case: repeated shutdown\nGenerating Memory Manager..." << std::endl;
     unsigned int wordSize = 2;
-    size_t numberOfWords1 = 10;
     MemoryManager memoryManager(wordSize, worstFit);
+    uint16_t words1 = blockWords(memoryManager, 1);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t used = 3 * words1 + 2 * words2;
+    size_t numberOfWords1 = used + 3;
     memoryManager.initialize(numberOfWords1);
+    memoryManager.setQuarantineLimit(0);
 
     uint16_t* testArray1 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 1));
     uint16_t* testArray2 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 2));
@@ -472,7 +631,7 @@ unsigned int testRepeatedShutdown()
 
     std::cout << "initializing Memory Manager..." << std::endl;
 
-    size_t numberOfWords2 = 20;
+    size_t numberOfWords2 = used + 13;
 
     memoryManager.initialize(numberOfWords2);
 
@@ -486,11 +645,11 @@ unsigned int testRepeatedShutdown()
     memoryManager.free(testArray8);
 
 
-    std::vector<uint8_t> correctBitmap{0x71, 0x00, 0x00};
-
-    std::vector<uint16_t> correctList = {1,3,7,13};
+    std::vector<uint16_t> correctList = {words1, static_cast<uint16_t>(words2 + words1), used, 13};
     uint16_t correctListLength = correctList.size() * 2;
 
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords2, correctList);
+
     unsigned int score = 0;
 
     std::cout << "Testing Memory Manager state\n" << std::endl;
@@ -514,8 +673,12 @@ unsigned int testMaxInitialization()
     MemoryManager memoryManager(wordSize, worstFit);
     memoryManager.initialize(numberOfWords);
 
+    // the second block takes every word the first left (guard words aside)
+    size_t guardWords = blockWords(memoryManager, 1) - 1;
+    size_t secondWords = numberOfWords - blockWords(memoryManager, 32768) - guardWords;
+
     uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 32768));
-    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 32767));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * secondWords));
 
     if(testArray1 && testArray2) {
         std::cout << "[CORRECT]\n" << std::endl;
@@ -586,12 +749,15 @@ unsigned int testReadingUsingGetMemoryStart()
 
     arrayContentItr = arrayContent.begin();
 
-    uint64_t* MemoryManagerContents = static_cast<uint64_t*>(memoryManager.getMemoryStart());
+    // the blocks are packed back to back, each blockWords apart
+    uint64_t* MemoryManagerStart = static_cast<uint64_t*>(memoryManager.getMemoryStart());
+    size_t stride = blockWords(memoryManager, 5);
     
-    for(auto content: arrayContent) {
-        if(content != *MemoryManagerContents++) {
-            std::cout << "Expected: " << content << std::endl;
-            std::cout << "Got: "  << *(MemoryManagerContents - 1) << std::endl;
+    for(size_t i = 0; i < arrayContent.size(); ++i) {
+        uint64_t* MemoryManagerContents = MemoryManagerStart + (i / 5) * stride + i % 5;
+        if(arrayContent[i] != *MemoryManagerContents) {
+            std::cout << "Expected: " << arrayContent[i] << std::endl;
+            std::cout << "Got: "  << *MemoryManagerContents << std::endl;
             std::cout << "[INCORRECT]\n" << std::endl;
             return score;
         }
@@ -605,162 +771,2087 @@ unsigned int testReadingUsingGetMemoryStart()
 }
 
 
-std::string vectorToString(const std::vector<uint16_t>& vector)
+unsigned int testFitStrategy()
 {
-    std::string vectorString = "";
+    std::cout << "Test Case: Fit strategy reading the live hole index" << std::endl;
+    unsigned int wordSize = 8;
 
-    vectorString += "[" + std::to_string(vector[0]) + ", " + std::to_string(vector[1]);
-    for (int i = 2; i < vector.size(); i +=2)
-    {
-        vectorString += "] - [" + std::to_string(vector[i]) + ", " + std::to_string(vector[i + 1]);
-    }
-    vectorString += "]";
+    // first fit: lowest-offset hole large enough, read straight from the hole index
+    FitStrategy firstFit = [](size_t sizeInWords, const HoleIndex& holes) -> int64_t {
+        for(auto& hole : holes) {
+            if(hole.second >= sizeInWords) {
+                return hole.first;
+            }
+        }
+        return -1;
+    };
+
+    MemoryManager memoryManager(wordSize, firstFit);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t words6 = blockWords(memoryManager, 6);
+    uint16_t used = words10 + words2 + words2 + words6;
+    size_t numberOfWords = used + 6;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
 
-    return vectorString;
-}
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
+    uint64_t* testArray3 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
+    uint64_t* testArray4 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 6));
 
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray3);
 
-unsigned int testGetBitmap(MemoryManager& memoryManager, uint16_t correctBitmapLength, std::vector<uint8_t> correctBitmap)
-{
-    unsigned int score = 0;
-    uint8_t* bitmap = static_cast<uint8_t*>(memoryManager.getBitmap());
-    uint8_t* bitmapEntryPoint = bitmap;
+    // first fit takes the 10 word hole at offset 0, where best fit would take the 2 word hole after the second block
+    uint64_t* testArray5 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
 
-    uint8_t lowerByte = *bitmap++;
-    uint8_t higherByte = *bitmap++;
-    uint16_t byteStreamLength = (higherByte << 8) | lowerByte;
+    std::vector<uint16_t> correctList = {words2, static_cast<uint16_t>(words10 - words2), static_cast<uint16_t>(words10 + words2), words2, used, 6};
+    uint16_t correctListLength = correctList.size() * 2;
 
-    std::cout << "Testing getBitmap" << std::endl;
-    std::cout << "Expected: " << std::endl;
-    std::cout << "[0x" << std::hex << (int)correctBitmap[0];
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, correctList);
 
-    for(uint16_t i = 1; i < correctBitmap.size(); ++i) {
-        std::cout << ", 0x" << std::hex << (int)correctBitmap[i];
-    }
-    std::cout << "]" << std::endl;
+    unsigned int score = 0;
 
+    std::cout << "Testing Memory Manager state after allocation" << std::endl;
 
-    std::cout << "\n";
-    std::cout << "Got:"  << std::endl;
-    std::cout << "[0x" << std::hex << (int)bitmap[0];
-    for(uint16_t i = 1; i < byteStreamLength; ++i) {
-        std::cout << ", 0x" << std::hex << (int)bitmap[i];
-    }
-    std::cout << "]" << std::endl;
+    score += testGetBitmap(memoryManager, correctBitmap.size(), correctBitmap);
+    score += testGetList(memoryManager, correctListLength, correctList);
+    score += testDumpMemoryMap(memoryManager, "testFitStrategy.txt", vectorToString(correctList));
 
-    for(uint16_t i = 0; i < byteStreamLength; ++i) {
-        if(bitmap[i] != correctBitmap[i]) {
-            delete [] bitmapEntryPoint;
-            std::cout << "[INCORRECT]\n" << std::endl;
-            return score;
-        }
-    }
+    memoryManager.shutdown();
 
-    ++score;
-    delete [] bitmapEntryPoint;
-    std::cout << "[CORRECT]\n" << std::endl;
     return score;
 }
 
 
-unsigned int testGetList(MemoryManager& memoryManager, uint16_t correctListLength, std::vector<uint16_t> correctList)
+unsigned int testMergeBothNeighbours()
 {
-    unsigned int score = 0;
-    std::cout << std::dec << std::endl;
-    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
-    uint16_t* listEntryPoint = list;
+    std::cout << "Test Case: Freeing a block between two holes" << std::endl;
+    unsigned int wordSize = 2;
+    MemoryManager memoryManager(wordSize, bestFit);
+    uint16_t freed = blockWords(memoryManager, 3) + blockWords(memoryManager, 4) + blockWords(memoryManager, 5);
+    uint16_t used = freed + blockWords(memoryManager, 2);
+    size_t numberOfWords = used + 6;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
 
-    uint16_t listLength = *list++;
+    uint16_t* testArray1 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 3));
+    uint16_t* testArray2 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 4));
+    uint16_t* testArray3 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 5));
+    uint16_t* testArray4 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 2));
 
-    uint16_t bytesPerEntry = 2;
-    uint16_t entriesInList = listLength * bytesPerEntry;
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray3);
+    memoryManager.free(testArray2);
 
-    std::cout << "Testing getList" << std::endl;
-    std::cout << "Expected: " << std::endl;
-    std::cout << std::dec << "[" << correctList[0];
-    for(uint16_t i = 1; i < correctList.size(); ++i) {
-        std::cout <<"] - [" << correctList[i];
-    }
-    std::cout << "]" << std::endl;
+    // all three holes become one, ending at the last allocated block
+    std::vector<uint16_t> correctList = {0, freed, used, 6};
+    uint16_t correctListLength = correctList.size() * 2;
 
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, correctList);
 
-    std::cout << "\n";
-    std::cout << "Got:"  << std::endl;
-    std::cout << std::dec << "[" << list[0];
-    for(uint16_t i = 1; i < entriesInList; ++i) {
-        std::cout <<"] - [" << list[i];
-    }
-    std::cout << "]" << std::endl;
+    unsigned int score = 0;
 
-    for(uint16_t i = 0; i < entriesInList; ++i) {
-        if(list[i] != correctList[i]) {
-            delete [] listEntryPoint;
-            std::cout << "[INCORRECT]\n" << std::endl;
-            return score;
-        }
-    }
+    std::cout << "Testing Memory Manager state after frees" << std::endl;
 
-    ++score;
+    score += testGetBitmap(memoryManager, correctBitmap.size(), correctBitmap);
+    score += testGetList(memoryManager, correctListLength, correctList);
+    score += testDumpMemoryMap(memoryManager, "testMergeBothNeighbours.txt", vectorToString(correctList));
+
+    memoryManager.shutdown();
 
-    delete [] listEntryPoint;
-    std::cout << "[CORRECT]\n" << std::endl;
     return score;
 }
 
-unsigned int testGetWordSize(MemoryManager& memoryManager, size_t correctWordSize)
+
+unsigned int testWideInitialization()
 {
-    std::cout << "Testing getWordSize" << std::endl;
-    std::cout << "Expected: " << correctWordSize << std::endl;
-    std::cout << "Got:" << memoryManager.getWordSize() << std::endl;
-    if(memoryManager.getWordSize() == correctWordSize) {
+    std::cout << "Test Case: initialization above 65536 words, Wide64 hole list" << std::endl;
+    unsigned int wordSize = 2;
+    size_t numberOfWords = 200000;
+    MemoryManager memoryManager(wordSize, bestFitWide);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+
+    uint16_t* testArray1 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 70000));
+    uint16_t* testArray2 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 100000));
+    uint16_t* testArray3 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 10));
+
+    memoryManager.free(testArray2);
+
+    unsigned int score = 0;
+
+    uint64_t used = blockWords(memoryManager, 70000) + blockWords(memoryManager, 100000) + blockWords(memoryManager, 10);
+    std::vector<uint64_t> correctList = {blockWords(memoryManager, 70000), blockWords(memoryManager, 100000), used, numberOfWords - used};
+
+    uint64_t* list = static_cast<uint64_t*>(memoryManager.getList());
+    std::cout << "Testing getList" << std::endl;
+    if(memoryManager.getHoleListFormat() == HoleListFormat::Wide64 && list[0] == correctList.size() / 2 &&
+       std::equal(correctList.begin(), correctList.end(), list + 1)) {
         std::cout << "[CORRECT]\n" << std::endl;
-        return 1;
+        ++score;
     }
     else {
         std::cout << "[INCORRECT]\n" << std::endl;
-        return 0;
     }
-}
+    delete [] list;
 
-unsigned int testGetMemoryLimit(MemoryManager& memoryManager, size_t correctMemoryLimit)
-{
     std::cout << "Testing getMemoryLimit" << std::endl;
-    std::cout << "Expected: " << correctMemoryLimit << std::endl;
-    std::cout << "Got:" << memoryManager.getMemoryLimit() << std::endl;
-    if(memoryManager.getMemoryLimit() == correctMemoryLimit) {
+    if(testArray1 && testArray3 && memoryManager.getMemoryLimit() == wordSize * numberOfWords) {
         std::cout << "[CORRECT]\n" << std::endl;
-        return 1;
+        ++score;
     }
     else {
         std::cout << "[INCORRECT]\n" << std::endl;
-        return 0;
     }
-}
 
-unsigned int testDumpMemoryMap(MemoryManager& memoryManager, std::string fileName, std::string correctFileContents)
-{
-    std::cout << "Testing dumpMemoryMap" << std::endl;
-  
-    memoryManager.dumpMemoryMap((char*)fileName.c_str());
-    std::ifstream testFile(fileName);
-    if (testFile.is_open()) {
-        std::string line;
-        std::getline(testFile, line);
-        testFile.close();
-        std::cout << "Expected: " << correctFileContents << std::endl;
-        std::cout << "Got:" << line << std::endl;
-        if(line == correctFileContents) {
-            std::cout << "[CORRECT]\n" << std::endl;
-            return 1;
-        }
-        else {
-            std::cout << "[INCORRECT]\n" << std::endl;
-            return 0;
-        }
+    // 75000 bytes of bitmap, past what a 2-byte length can hold
+    std::cout << "Testing getBitmap above 65535 bytes (8-byte length)" << std::endl;
+    numberOfWords = 600000;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.allocate(sizeof(uint16_t) * 10);
+    testArray2 = static_cast<uint16_t*>(memoryManager.allocate(sizeof(uint16_t) * 530000));
+    memoryManager.allocate(sizeof(uint16_t) * 5);
+    memoryManager.free(testArray2);
+
+    used = blockWords(memoryManager, 10) + blockWords(memoryManager, 530000) + blockWords(memoryManager, 5);
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, std::vector<uint64_t>{blockWords(memoryManager, 10), blockWords(memoryManager, 530000), used, numberOfWords - used});
+
+    uint8_t* bitmap = static_cast<uint8_t*>(memoryManager.getBitmap());
+    uint64_t bitmapLength = 0;
+    for(unsigned int i = 0; i < 8; ++i) {
+        bitmapLength |= (uint64_t)bitmap[i] << (i * 8);
+    }
+    uint8_t* bits = bitmap + 8;
+    if(bitmapLength == 75000 && std::equal(correctBitmap.begin(), correctBitmap.end(), bits)) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        ++score;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    delete [] bitmap;
+
+    // 2 * (SIZE_MAX / 2 + 5) bytes wraps around to 8, no block may be acquired for it
+    std::cout << "Testing initialization whose byte size overflows" << std::endl;
+    memoryManager.initialize(SIZE_MAX / 2 + 5);
+    if(memoryManager.getMemoryLimit() == 0 && memoryManager.getMemoryStart() == nullptr
+       && memoryManager.allocate(sizeof(uint16_t)) == nullptr) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        ++score;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
     }
-    return 0;
-}
 
+    memoryManager.shutdown();
 
+    return score;
+}
 
 
+unsigned int testMmapBackingStore()
+{
+    std::cout << "Test Case: mmap backing store, 4 byte words read using GetMemoryStart" << std::endl;
+    unsigned int wordSize = 4;
+    size_t numberOfWords = 30;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.setBackingStore(BackingStore::Mmap);
+    memoryManager.initialize(numberOfWords);
+
+    std::vector<uint32_t> arrayContent{1, 12, 13, 2, 22, 23, 3, 32, 33};
+    std::vector<uint32_t>::const_iterator arrayContentItr = arrayContent.begin();
+
+    for(int i = 0; i < 3; ++i) {
+        uint32_t* testArray = static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * 3));
+        for(uint16_t j = 0; j < 3; ++j) {
+            testArray[j] = *arrayContentItr++;
+        }
+    }
+
+    unsigned int score = 0;
+
+    // words are 4 bytes apart, so the three blocks are packed back to back
+    std::cout << "Testing memory contents" << std::endl;
+    uint32_t* MemoryManagerContents = static_cast<uint32_t*>(memoryManager.getMemoryStart());
+    size_t stride = blockWords(memoryManager, 3);
+    bool packed = true;
+    for(size_t i = 0; i < arrayContent.size(); ++i) {
+        packed = packed && MemoryManagerContents[(i / 3) * stride + i % 3] == arrayContent[i];
+    }
+    if(packed) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        ++score;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    score += testGetMemoryLimit(memoryManager, wordSize * numberOfWords);
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testBitmapNextFit()
+{
+    std::cout << "Test Case: Bitmap next fit" << std::endl;
+    unsigned int wordSize = 8;
+    MemoryManager memoryManager(wordSize, BitmapNextFit());
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t words6 = blockWords(memoryManager, 6);
+    uint16_t used = words10 + words2 + words2 + words6;
+    size_t numberOfWords = used + 6;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
+    uint64_t* testArray3 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
+    uint64_t* testArray4 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 6));
+
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray3);
+
+    // next fit carries on after the last allocation rather than reusing the holes before it
+    uint64_t* testArray5 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
+
+    std::vector<uint16_t> correctList = {0, words10, static_cast<uint16_t>(words10 + words2), words2, static_cast<uint16_t>(used + words2), static_cast<uint16_t>(6 - words2)};
+    uint16_t correctListLength = correctList.size() * 2;
+
+    std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, correctList);
+
+    unsigned int score = 0;
+
+    std::cout << "Testing Memory Manager state after allocation" << std::endl;
+
+    score += testGetBitmap(memoryManager, correctBitmap.size(), correctBitmap);
+    score += testGetList(memoryManager, correctListLength, correctList);
+
+    memoryManager.shutdown();
+
+    // an aligned request asks for 7 words of slack it does not use; the cursor must stop at the end of the aligned block
+    memoryManager.initialize(64);
+    uintptr_t startAddress = reinterpret_cast<uintptr_t>(memoryManager.getMemoryStart());
+    size_t leadWords = ((64 - startAddress % 64) % 64) / wordSize;
+    memoryManager.allocate(sizeof(uint64_t) * (leadWords == 0 ? 8 : leadWords));
+    uint8_t* alignedArray = static_cast<uint8_t*>(memoryManager.allocateAligned(sizeof(uint64_t) * 8, 64));
+    uint8_t* nextArray = static_cast<uint8_t*>(memoryManager.allocate(sizeof(uint64_t) * 2));
+
+    std::cout << "Testing cursor after an aligned allocation" << std::endl;
+    if (alignedArray != nullptr && nextArray == alignedArray + blockWords(memoryManager, 8) * wordSize)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testConcurrentAllocate()
+{
+    std::cout << "Test Case: Concurrent allocate / free from 4 threads" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 4000;
+    ConcurrentMemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+
+    std::vector<std::thread> threads;
+    std::vector<unsigned int> corrupted(4, 0);
+
+    for(unsigned int t = 0; t < 4; ++t) {
+        threads.emplace_back([&memoryManager, &corrupted, t]() {
+            std::vector<uint64_t*> testArrays;
+            for(uint64_t i = 0; i < 2000; ++i) {
+                uint64_t* testArray = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * (1 + i % 6)));
+                if(testArray) {
+                    testArray[0] = t * 10000 + i;
+                    testArrays.push_back(testArray);
+                }
+                if(testArrays.size() > 20) {
+                    if(testArrays.front()[0] / 10000 != t) {
+                        ++corrupted[t];
+                    }
+                    memoryManager.free(testArrays.front());
+                    testArrays.erase(testArrays.begin());
+                }
+            }
+            for(auto testArray : testArrays) {
+                memoryManager.free(testArray);
+            }
+            memoryManager.flushThreadCache();
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    // with every thread cache flushed, the arena is one hole again
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    bool correct = list[0] == 1 && list[1] == 0 && list[2] == numberOfWords &&
+                   std::count(corrupted.begin(), corrupted.end(), 0) == 4;
+    delete [] list;
+
+    unsigned int score = 0;
+    if(correct) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // the freed blocks stay in this thread's magazine until the arena runs out of room
+    std::cout << "Test Case: A full arena takes back the calling thread's cached blocks" << std::endl;
+    memoryManager.initialize(1000);
+    memoryManager.setQuarantineLimit(0);
+    std::vector<void*> testArrays;
+    for(unsigned int i = 0; i < ConcurrentMemoryManager::magazineSize; ++i) {
+        testArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * 16));
+    }
+    for(auto testArray : testArrays) {
+        memoryManager.free(testArray);
+    }
+    void* largeArray = memoryManager.allocate(sizeof(uint64_t) * 500);
+    uint64_t* smallArray = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 16));
+    if(std::count(testArrays.begin(), testArrays.end(), nullptr) == 0 && largeArray != nullptr && smallArray != nullptr) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testSlabAllocator()
+{
+    std::cout << "Test Case: Slab allocator, free slab blocks reported as holes" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 200;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+
+    unsigned int score = 0;
+    {
+        SlabAllocator slabAllocator(memoryManager);
+        uint16_t slabWords = blockWords(memoryManager, 64);
+
+        // one slab of 64 one-word blocks is carved at offset 0
+        uint64_t* testArray1 = static_cast<uint64_t*>(slabAllocator.allocate(sizeof(uint64_t)));
+        uint64_t* testArray2 = static_cast<uint64_t*>(slabAllocator.allocate(sizeof(uint64_t)));
+        uint64_t* testArray3 = static_cast<uint64_t*>(slabAllocator.allocate(sizeof(uint64_t)));
+
+        slabAllocator.free(testArray2);
+
+        // the free slab blocks merge with the hole after the slab, unless a hardened guard word sits between them
+        std::vector<uint16_t> correctList = {1, 1, 3, 197};
+        if(slabWords != 64) {
+            correctList = {1, 1, 3, 61, slabWords, static_cast<uint16_t>(numberOfWords - slabWords)};
+        }
+        uint16_t correctListLength = correctList.size() * 2;
+
+        std::vector<uint8_t> correctBitmap = bitmapOf(numberOfWords, correctList);
+
+        std::cout << "Testing Memory Manager state after slab allocations" << std::endl;
+
+        score += testGetBitmap(memoryManager, correctBitmap.size(), correctBitmap);
+        score += testGetList(memoryManager, correctListLength, correctList);
+
+        slabAllocator.free(testArray1);
+        slabAllocator.free(testArray3);
+    }
+
+    // destroying the slab allocator gives its slab back
+    std::vector<uint16_t> correctListAfter = {0, 200};
+    score += testGetList(memoryManager, correctListAfter.size() * 2, correctListAfter);
+
+    // a slab carved while a region is active outlives the region, its blocks never overlap later allocations
+    std::cout << "Test Case: Slabs carved inside a region are not freed by popRegion" << std::endl;
+    {
+        SlabAllocator slabAllocator(memoryManager);
+        memoryManager.pushRegion(0);
+        uint8_t* testArray1 = static_cast<uint8_t*>(slabAllocator.allocate(sizeof(uint64_t)));
+        memoryManager.popRegion();
+        uint8_t* testArray2 = static_cast<uint8_t*>(slabAllocator.allocate(sizeof(uint64_t)));
+        uint8_t* largeArray = static_cast<uint8_t*>(memoryManager.allocate(sizeof(uint64_t) * 100));
+
+        bool apart = testArray1 != nullptr && testArray2 != nullptr && largeArray != nullptr &&
+                     (testArray2 < largeArray || testArray2 >= largeArray + sizeof(uint64_t) * 100);
+        if(apart) {
+            std::cout << "[CORRECT]\n" << std::endl;
+            score++;
+        }
+        else {
+            std::cout << "[INCORRECT]\n" << std::endl;
+        }
+
+        memoryManager.free(largeArray);
+        slabAllocator.free(testArray1);
+        slabAllocator.free(testArray2);
+    }
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testBatchAllocate()
+{
+    std::cout << "Test Case: Batch allocate & free" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+
+    // one extent of 2 + 3 + 1 words, the zero size entry gets nullptr
+    std::vector<size_t> sizes = {16, 24, 0, 8};
+    std::vector<void*> blocks;
+    memoryManager.allocateBatch(sizes, blocks);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t used = words2 + blockWords(memoryManager, 3) + blockWords(memoryManager, 1);
+
+    unsigned int score = 0;
+    std::vector<uint16_t> correctList = {used, static_cast<uint16_t>(numberOfWords - used)};
+    std::cout << "Testing Memory Manager state after batch allocation" << std::endl;
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    // the freed tail block merges with the hole after it, the head block becomes a hole of its own
+    memoryManager.freeBatch({blocks[3], blocks[0], blocks[2]});
+    uint16_t tail = used - blockWords(memoryManager, 1);
+    std::vector<uint16_t> correctListPartial = {0, words2, tail, static_cast<uint16_t>(numberOfWords - tail)};
+    score += testGetList(memoryManager, correctListPartial.size() * 2, correctListPartial);
+
+    memoryManager.freeBatch({blocks[1], blocks[1]});
+    std::vector<uint16_t> correctListAfter = {0, 100};
+    score += testGetList(memoryManager, correctListAfter.size() * 2, correctListAfter);
+
+    // blocks carved from one hole are counted & sampled one by one, the batch is timed once
+    std::cout << "Test Case: Batch allocations show in stats & samples" << std::endl;
+    memoryManager.resetStats();
+    memoryManager.setLatencySampling(1);
+    memoryManager.setSamplingInterval(1);
+    memoryManager.allocateBatch(sizes, blocks);
+    MemoryStats stats = memoryManager.getStats();
+    uint64_t allocateCalls = 0;
+    for(unsigned int i = 0; i < MemoryStats::latencyBucketCount; ++i) {
+        allocateCalls += stats.allocateLatency[i];
+    }
+    if(stats.allocations == 3 && allocateCalls == 1 && memoryManager.getSampledAllocations().size() == 3) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testBasicMemoryManager()
+{
+    std::cout << "Test Case: Compile-time best fit policy" << std::endl;
+    size_t numberOfWords = 100;
+    BasicMemoryManager<BestFitPolicy, 8> memoryManager;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+
+    void* testArray1 = memoryManager.allocate(10);
+    void* testArray2 = memoryManager.allocate(24);
+    memoryManager.free(testArray1);
+
+    // best fit picks the 2 word hole at the start over the tail
+    void* testArray3 = memoryManager.allocate(8);
+    uint16_t words1 = blockWords(memoryManager, 1);
+    uint16_t words2 = blockWords(memoryManager, 2);
+    uint16_t used = words2 + blockWords(memoryManager, 3);
+
+    unsigned int score = 0;
+    std::cout << "Testing reuse of the smallest hole" << std::endl;
+    if (testArray3 == memoryManager.getMemoryStart())
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::vector<uint16_t> correctList = {words1, static_cast<uint16_t>(words2 - words1), used, static_cast<uint16_t>(numberOfWords - used)};
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    // the inlined search is counted & sampled like any other allocate
+    std::cout << "Testing stats & samples of the compile-time allocate" << std::endl;
+    memoryManager.resetStats();
+    memoryManager.setSamplingInterval(1);
+    void* testArray4 = memoryManager.allocate(16);
+    bool sampled = memoryManager.getSampledAllocations().size() == 1;
+    memoryManager.free(testArray4);
+    MemoryStats stats = memoryManager.getStats();
+    if (testArray4 != nullptr && sampled && stats.allocations == 1 && stats.frees == 1 && stats.sizeClassCounts[1] == 1)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    memoryManager.setSamplingInterval(0);
+
+    memoryManager.free(testArray2);
+    memoryManager.free(testArray3);
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testBuddyEngine()
+{
+    std::cout << "Test Case: Buddy engine" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords, EngineType::Buddy);
+
+    // 100 words start out as free blocks of 64, 32 & 4 words
+    // 3 words round up to the 4 word block, 1 word splits the 32 word block down to its first word
+    uint8_t* testArray1 = static_cast<uint8_t*>(memoryManager.allocate(24));
+    uint8_t* testArray2 = static_cast<uint8_t*>(memoryManager.allocate(8));
+    uint8_t* start = static_cast<uint8_t*>(memoryManager.getMemoryStart());
+
+    unsigned int score = 0;
+    std::cout << "Testing block placement" << std::endl;
+    if (testArray1 == start + 96 * wordSize && testArray2 == start + 64 * wordSize)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // a 1 word block takes 2 words with a hardened guard, both powers of two
+    uint16_t words1 = blockWords(memoryManager, 1);
+    std::vector<uint16_t> correctList = {0, 64, static_cast<uint16_t>(64 + words1), static_cast<uint16_t>(32 - words1)};
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    // freeing both merges every buddy back together
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray2);
+    std::vector<uint16_t> correctListAfter = {0, 100};
+    score += testGetList(memoryManager, correctListAfter.size() * 2, correctListAfter);
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testTlsfEngine()
+{
+    std::cout << "Test Case: TLSF engine" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords, EngineType::Tlsf);
+
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 20));
+    memoryManager.free(testArray1);
+
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t used = words10 + blockWords(memoryManager, 20);
+
+    unsigned int score = 0;
+    std::vector<uint16_t> correctList = {0, words10, used, static_cast<uint16_t>(numberOfWords - used)};
+    std::cout << "Testing Memory Manager state after TLSF allocations" << std::endl;
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    std::cout << "Testing allocation larger than the memory block" << std::endl;
+    if (memoryManager.allocate(sizeof(uint64_t) * 101) == nullptr)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // freeing the second block merges it with the holes on both sides
+    memoryManager.free(testArray2);
+    std::vector<uint16_t> correctListAfter = {0, 100};
+    score += testGetList(memoryManager, correctListAfter.size() * 2, correctListAfter);
+
+    // rounding up skips the request's own list, whose first block is still tried
+    std::cout << "Testing allocation of the whole memory block" << std::endl;
+    size_t wholeWords = numberOfWords - (blockWords(memoryManager, 1) - 1);
+    if (memoryManager.allocate(sizeof(uint64_t) * wholeWords) == memoryManager.getMemoryStart())
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testCompaction()
+{
+    std::cout << "Test Case: Compaction of relocatable blocks" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    uint16_t words10 = blockWords(memoryManager, 10);
+
+    Handle handle1 = memoryManager.allocateHandle(sizeof(uint64_t) * 10);
+    void* pinnedArray = memoryManager.allocate(sizeof(uint64_t) * 10);
+    Handle handle2 = memoryManager.allocateHandle(sizeof(uint64_t) * 10);
+    Handle handle3 = memoryManager.allocateHandle(sizeof(uint64_t) * 10);
+
+    uint64_t* testArray3 = static_cast<uint64_t*>(memoryManager.resolve(handle3));
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        testArray3[i] = i * i;
+    }
+
+    memoryManager.freeHandle(handle1);
+    memoryManager.freeHandle(handle2);
+
+    // the pinned block keeps the hole before it, the last block slides down into the hole after it
+    memoryManager.compact();
+
+    unsigned int score = 0;
+    std::vector<uint16_t> correctList = {0, words10, static_cast<uint16_t>(3 * words10), static_cast<uint16_t>(numberOfWords - 3 * words10)};
+    std::cout << "Testing Memory Manager state after compaction" << std::endl;
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    uint64_t* movedArray3 = static_cast<uint64_t*>(memoryManager.resolve(handle3));
+    std::cout << "Testing relocated address" << std::endl;
+    if (movedArray3 == static_cast<uint64_t*>(memoryManager.getMemoryStart()) + 2 * words10)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    bool contentsMoved = true;
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        contentsMoved = contentsMoved && movedArray3[i] == i * i;
+    }
+    std::cout << "Testing relocated contents" << std::endl;
+    if (contentsMoved)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.free(pinnedArray);
+    memoryManager.freeHandle(handle3);
+    memoryManager.shutdown();
+
+    // pinned blocks between holes count against the budget, so a step stops before reaching the relocatable block behind them
+    std::cout << "Testing compaction step over pinned blocks" << std::endl;
+    numberOfWords = 1000;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    std::vector<void*> pinnedArrays;
+    std::vector<void*> freedArrays;
+    for (unsigned int i = 0; i < 20; i++)
+    {
+        pinnedArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * 10));
+        freedArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * 10));
+    }
+    Handle handle4 = memoryManager.allocateHandle(sizeof(uint64_t) * 10);
+    void* lastArray = memoryManager.resolve(handle4);
+    for (void* freed : freedArrays)
+    {
+        memoryManager.free(freed);
+    }
+
+    bool stoppedEarly = memoryManager.compactStep(5 * words10) && memoryManager.resolve(handle4) == lastArray;
+    while (memoryManager.compactStep(5 * words10))
+    {
+    }
+    if (stoppedEarly && memoryManager.resolve(handle4) == static_cast<uint8_t*>(memoryManager.getMemoryStart()) + 39 * words10 * wordSize)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    for (void* pinned : pinnedArrays)
+    {
+        memoryManager.free(pinned);
+    }
+    memoryManager.freeHandle(handle4);
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testRegions()
+{
+    std::cout << "Test Case: Region push / pop" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t reserveWords = blockWords(memoryManager, 20);
+    uint16_t bumpedWords = blockWords(memoryManager, 5) + words10;
+
+    void* testArray1 = memoryManager.allocate(sizeof(uint64_t) * 10);
+
+    // a 20 word block is reserved after the first; the next two blocks are bumped out of it, the third does not fit & goes to the hole after it
+    memoryManager.pushRegion(sizeof(uint64_t) * 20);
+    void* testArray2 = memoryManager.allocate(sizeof(uint64_t) * 5);
+    memoryManager.allocate(sizeof(uint64_t) * 10);
+    memoryManager.allocate(sizeof(uint64_t) * 10);
+
+    unsigned int score = 0;
+    std::cout << "Testing bump allocation" << std::endl;
+    if (testArray2 == static_cast<uint8_t*>(memoryManager.getMemoryStart()) + words10 * wordSize)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // the unused tail of the reserved block is reported as a hole
+    uint16_t used = 2 * words10 + reserveWords;
+    std::vector<uint16_t> correctList = {static_cast<uint16_t>(words10 + bumpedWords), static_cast<uint16_t>(reserveWords - bumpedWords), used, static_cast<uint16_t>(numberOfWords - used)};
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    memoryManager.popRegion();
+    std::vector<uint16_t> correctListAfter = {words10, static_cast<uint16_t>(numberOfWords - words10)};
+    score += testGetList(memoryManager, correctListAfter.size() * 2, correctListAfter);
+
+    memoryManager.free(testArray1);
+    memoryManager.shutdown();
+
+    // the default reserve (512 words here) takes the first 32 blocks (30 with hardened guards), the rest are recorded
+    memoryManager.initialize(4096);
+    reserveWords = blockWords(memoryManager, defaultRegionReserve / wordSize);
+    size_t bumpedCount = reserveWords / blockWords(memoryManager, 16);
+    memoryManager.pushRegion();
+    std::vector<void*> blocks;
+    for (int i = 0; i < 200; i++)
+    {
+        blocks.push_back(memoryManager.allocate(sizeof(uint64_t) * 16));
+    }
+    bool bumped = blocks[0] == memoryManager.getMemoryStart()
+        && blocks[bumpedCount - 1] == static_cast<uint8_t*>(blocks[0]) + (bumpedCount - 1) * blockWords(memoryManager, 16) * wordSize
+        && blocks[bumpedCount] == static_cast<uint8_t*>(blocks[0]) + reserveWords * wordSize;
+
+    // recorded blocks freed & moved early, out of order, are not freed again by popRegion
+    for (int i = 199; i >= 32; i -= 3)
+    {
+        memoryManager.free(blocks[i]);
+    }
+    for (int i = 33; i < 199; i += 3)
+    {
+        memoryManager.free(blocks[i]);
+    }
+    void* moved = memoryManager.reallocate(blocks[35], sizeof(uint64_t) * 100);
+    memoryManager.popRegion();
+
+    std::cout << "Testing default region reserve" << std::endl;
+    if (bumped && moved != blocks[35] && memoryManager.getRegionDepth() == 0)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    std::vector<uint16_t> correctListEmpty = {0, 4096};
+    score += testGetList(memoryManager, correctListEmpty.size() * 2, correctListEmpty);
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testReallocate()
+{
+    std::cout << "Test Case: Reallocate in place & by copying" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    uint16_t words5 = blockWords(memoryManager, 5);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t grownEnd = words10 + blockWords(memoryManager, 30);
+    uint16_t movedEnd = grownEnd + blockWords(memoryManager, 20);
+
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    for (uint64_t i = 0; i < 5; i++)
+    {
+        testArray1[i] = i + 1;
+    }
+
+    // shrinking leaves a hole behind the first block, growing takes the hole after the second
+    uint64_t* shrunkArray1 = static_cast<uint64_t*>(memoryManager.reallocate(testArray1, sizeof(uint64_t) * 5));
+    uint64_t* grownArray2 = static_cast<uint64_t*>(memoryManager.reallocate(testArray2, sizeof(uint64_t) * 30));
+
+    unsigned int score = 0;
+    std::cout << "Testing resizing in place" << std::endl;
+    if (shrunkArray1 == testArray1 && grownArray2 == testArray2)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::vector<uint16_t> correctList = {words5, static_cast<uint16_t>(words10 - words5), grownEnd, static_cast<uint16_t>(numberOfWords - grownEnd)};
+    score += testGetList(memoryManager, correctList.size() * 2, correctList);
+
+    // no room after the first block, so it is copied to the hole after the second
+    uint64_t* movedArray1 = static_cast<uint64_t*>(memoryManager.reallocate(shrunkArray1, sizeof(uint64_t) * 20));
+    std::vector<uint16_t> correctListAfter = {0, words10, movedEnd, static_cast<uint16_t>(numberOfWords - movedEnd)};
+    bool contentsMoved = movedArray1 == testArray1 + grownEnd;
+    for (uint64_t i = 0; i < 5 && contentsMoved; i++)
+    {
+        contentsMoved = movedArray1[i] == i + 1;
+    }
+    std::cout << "Testing copied contents" << std::endl;
+    if (contentsMoved)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    score += testGetList(memoryManager, correctListAfter.size() * 2, correctListAfter);
+
+    memoryManager.free(movedArray1);
+    memoryManager.free(grownArray2);
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testGrowableMemoryManager()
+{
+    std::cout << "Test Case: Growable memory manager" << std::endl;
+    unsigned int wordSize = 8;
+    size_t chunkSize = 100;
+    GrowableMemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(chunkSize);
+
+    // the second block does not fit in the rest of the first chunk
+    void* testArray1 = memoryManager.allocate(sizeof(uint64_t) * 80);
+    void* testArray2 = memoryManager.allocate(sizeof(uint64_t) * 50);
+
+    unsigned int score = 0;
+    std::cout << "Testing a second chunk is mapped" << std::endl;
+    if (memoryManager.getChunkCount() == 2 && memoryManager.findChunk(testArray2) == &memoryManager.getChunk(1))
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // the emptied second chunk stays mapped as the spare & is reused
+    memoryManager.free(testArray2);
+    void* testArray3 = memoryManager.allocate(sizeof(uint64_t) * 90);
+    uint16_t words90 = blockWords(memoryManager.getChunk(1), 90);
+    std::vector<uint16_t> correctList = {words90, static_cast<uint16_t>(chunkSize - words90)};
+    std::cout << "Testing the spare chunk is reused" << std::endl;
+    score += testGetList(memoryManager.getChunk(1), correctList.size() * 2, correctList);
+
+    // with the second chunk the spare again, the emptied first chunk is released
+    memoryManager.free(testArray3);
+    memoryManager.free(testArray1);
+    std::cout << "Testing empty chunks are released" << std::endl;
+    if (memoryManager.getChunkCount() == 1 && memoryManager.getMemoryLimit() == chunkSize * wordSize)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // a block of a whole chunk gets a chunk it fits in (with its canary in hardened builds)
+    memoryManager.initialize(64);
+    void* testArray4 = memoryManager.allocate(sizeof(uint64_t) * 64);
+    std::cout << "Testing a request of a whole chunk" << std::endl;
+    if (testArray4 != nullptr && memoryManager.findChunk(testArray4) != nullptr)
+    {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else
+    {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    memoryManager.free(testArray4);
+
+    memoryManager.shutdown();
+
+    return score;
+}
+
+
+unsigned int testRemoteFree()
+{
+    std::cout << "Test Case: Blocks freed by another thread return to their owner" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    ConcurrentMemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+
+    // one refill of the 2 word bucket, handed to a consumer thread to free
+    std::vector<void*> testArrays;
+    for(unsigned int i = 0; i < ConcurrentMemoryManager::batchSize; ++i) {
+        testArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * 2));
+    }
+    uint16_t* listBefore = static_cast<uint16_t*>(memoryManager.getList());
+
+    std::thread consumer([&memoryManager, &testArrays]() {
+        for(auto testArray : testArrays) {
+            memoryManager.free(testArray);
+        }
+    });
+    consumer.join();
+
+    // the owner gets the same blocks back without touching the arena
+    bool correct = true;
+    for(unsigned int i = 0; i < ConcurrentMemoryManager::batchSize; ++i) {
+        void* testArray = memoryManager.allocate(sizeof(uint64_t) * 2);
+        correct = correct && std::find(testArrays.begin(), testArrays.end(), testArray) != testArrays.end();
+    }
+    uint16_t* listAfter = static_cast<uint16_t*>(memoryManager.getList());
+    correct = correct && std::equal(listBefore, listBefore + 1 + 2 * listBefore[0], listAfter);
+    delete [] listBefore;
+    delete [] listAfter;
+
+    unsigned int score = 0;
+    if(correct) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // the producer exits with blocks still cached & blocks handed out, nothing is stranded on its cache
+    std::cout << "Test Case: Blocks freed to a thread that has exited can be allocated again" << std::endl;
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    testArrays.clear();
+    std::thread producer([&memoryManager, &testArrays]() {
+        for(unsigned int i = 0; i < ConcurrentMemoryManager::batchSize / 2; ++i) {
+            testArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * 2));
+        }
+    });
+    producer.join();
+
+    for(auto testArray : testArrays) {
+        memoryManager.free(testArray);
+    }
+    memoryManager.flushThreadCache();
+
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    correct = std::count(testArrays.begin(), testArrays.end(), nullptr) == 0 && list[0] == 1 && list[1] == 0 && list[2] == numberOfWords;
+    delete [] list;
+
+    memoryManager.shutdown();
+
+    if(correct) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    return score;
+}
+
+
+unsigned int testNumaMemoryManager()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: One arena per NUMA node, allocating on the local node" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    NumaMemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords, NumaPolicy::FirstTouch);
+
+    unsigned int node = memoryManager.getCurrentNode();
+    uint64_t* testArray = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    if(memoryManager.getNodeCount() >= 1 && memoryManager.getMemoryLimit() == memoryManager.getNodeCount() * numberOfWords * wordSize
+       && testArray && memoryManager.findNode(testArray) == int(node)) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // hardened builds hold the block in the arena's quarantine, which an empty arena may still have
+    std::cout << "Test Case: Freeing routes the block back to its node's arena" << std::endl;
+    memoryManager.free(testArray);
+    if(memoryManager.getArena(node).isEmpty()) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+
+unsigned int testAllocatorStats()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Stats count blocks, bytes in use & holes" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    memoryManager.setLatencySampling(1);                 // time every call
+
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 20));
+    uint64_t* testArray3 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 30));
+    memoryManager.free(testArray2);
+
+    size_t inUse = blockWords(memoryManager, 10) + blockWords(memoryManager, 30);
+    size_t peak = inUse + blockWords(memoryManager, 20);
+    size_t largestHole = numberOfWords - peak;
+    size_t freeWords = numberOfWords - inUse;
+
+    MemoryStats stats = memoryManager.getStats();
+    if(stats.allocations == 3 && stats.frees == 1 && stats.sizeClassCounts[3] == 1 && stats.sizeClassCounts[4] == 2
+       && stats.bytesInUse == inUse * wordSize && stats.peakBytesInUse == peak * wordSize
+       && stats.holeCount == 2 && stats.largestHole == largestHole * wordSize && stats.freeBytes == freeWords * wordSize
+       && std::abs(stats.fragmentation - (1.0 - double(largestHole) / freeWords)) < 1e-9) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Stats count failures, merges & latencies of every call" << std::endl;
+    memoryManager.allocate(sizeof(uint64_t) * 2000);
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray3);
+
+    stats = memoryManager.getStats();
+    uint64_t allocateCalls = 0;
+    uint64_t freeCalls = 0;
+    for(unsigned int i = 0; i < MemoryStats::latencyBucketCount; ++i) {
+        allocateCalls += stats.allocateLatency[i];
+        freeCalls += stats.freeLatency[i];
+    }
+    bool correct = stats.failedAllocations == 1 && stats.frees == 3 && stats.merges == 3 && stats.bytesInUse == 0
+                   && stats.holeCount == 1 && stats.fragmentation == 0 && allocateCalls == 4 && freeCalls == 3;
+
+    // Resetting keeps the bytes in use as the new peak
+    memoryManager.resetStats();
+    stats = memoryManager.getStats();
+    correct = correct && stats.allocations == 0 && stats.frees == 0 && stats.peakBytesInUse == 0;
+
+    // By default only one call in AllocatorStats::defaultLatencySampling is timed, every call is counted
+    memoryManager.setLatencySampling(AllocatorStats::defaultLatencySampling);
+    for(unsigned int i = 0; i < 2 * AllocatorStats::defaultLatencySampling; ++i) {
+        memoryManager.free(memoryManager.allocate(sizeof(uint64_t)));
+    }
+    stats = memoryManager.getStats();
+    allocateCalls = 0;
+    freeCalls = 0;
+    for(unsigned int i = 0; i < MemoryStats::latencyBucketCount; ++i) {
+        allocateCalls += stats.allocateLatency[i];
+        freeCalls += stats.freeLatency[i];
+    }
+    correct = correct && stats.allocations == 2 * AllocatorStats::defaultLatencySampling && allocateCalls + freeCalls == 4
+              && stats.latencySampleInterval == AllocatorStats::defaultLatencySampling;
+
+    // The last size class ends at 2^64 words, which is printed without shifting past 64 bits
+    MemoryStats hugeStats;
+    hugeStats.sizeClassCounts[MemoryStats::sizeClassCount - 1] = 1;
+    std::ostringstream text;
+    text << hugeStats;
+    if(correct && text.str().find("size class [9223372036854775808, 18446744073709551616) words: 1") != std::string::npos) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+
+unsigned int testBinaryMemoryMap()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Binary memory map reads back as the same holes" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 100000;
+    MemoryManager memoryManager(wordSize, indexedBestFit);
+    memoryManager.initialize(numberOfWords);
+
+    std::vector<void*> testArrays;
+    for(unsigned int i = 0; i < 200; ++i) {
+        testArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * (i % 7 + 1)));
+    }
+    for(unsigned int i = 0; i < testArrays.size(); i += 3) {
+        memoryManager.free(testArrays[i]);
+    }
+
+    std::string fileName = "binaryMemoryMap";
+    std::vector<std::pair<size_t, size_t>> expectedHoles(memoryManager.getHoleIndex().begin(), memoryManager.getHoleIndex().end());
+    MemoryMapSnapshot snapshot;
+    if(memoryManager.dumpMemoryMapBinary((char*)fileName.c_str()) == 0 && readMemoryMap(fileName.c_str(), snapshot)
+       && snapshot.wordSize == wordSize && snapshot.sizeInWords == numberOfWords && snapshot.holes == expectedHoles) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // The sink allocates while the map is sent, the map stays as it was when the dump began
+    std::cout << "Test Case: Streamed memory map is one snapshot & text dumps replace the file" << std::endl;
+    std::vector<uint8_t> streamed;
+    memoryManager.dumpMemoryMapBinary([&memoryManager, &streamed](const uint8_t* data, size_t bytes) {
+        memoryManager.allocate(sizeof(uint64_t));
+        streamed.insert(streamed.end(), data, data + bytes);
+        return true;
+    });
+    bool correct = readMemoryMap(streamed.data(), streamed.size(), snapshot) && snapshot.holes == expectedHoles
+                   && !readMemoryMap(streamed.data(), streamed.size() - 1, snapshot);
+
+    memoryManager.dumpMemoryMap((char*)fileName.c_str());
+    for(unsigned int i = 0; i < testArrays.size(); ++i) {
+        if(i % 3 != 0) {
+            memoryManager.free(testArrays[i]);
+        }
+    }
+    memoryManager.shutdown();
+    memoryManager.initialize(numberOfWords);
+    memoryManager.dumpMemoryMap((char*)fileName.c_str());
+
+    std::ifstream testFile(fileName);
+    std::string contents((std::istreambuf_iterator<char>(testFile)), std::istreambuf_iterator<char>());
+    if(correct && contents == "[0, 100000]") {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+
+unsigned int testAllocationSampling()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Sampled allocations are tracked with their stacks until freed" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+
+    // Sampling is off by default
+    memoryManager.free(memoryManager.allocate(sizeof(uint64_t) * 10));
+    bool correct = memoryManager.getSampledAllocations().empty();
+
+    // A mean of one byte between samples samples every allocation
+    memoryManager.setSamplingInterval(1);
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 20));
+    uint64_t* testArray3 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 30));
+    memoryManager.free(testArray2);
+
+    std::vector<SampledAllocation> samples = memoryManager.getSampledAllocations();
+    std::sort(samples.begin(), samples.end(), [](const SampledAllocation& a, const SampledAllocation& b) { return a.address < b.address; });
+    if(correct && samples.size() == 2 && samples[0].address == testArray1 && samples[0].sizeInBytes == sizeof(uint64_t) * 10
+       && samples[1].address == testArray3 && samples[1].sizeInBytes == sizeof(uint64_t) * 30 && !samples[0].stack.empty()) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Heap profile lists the live samples in pprof format" << std::endl;
+    std::string fileName = "heapProfile";
+    memoryManager.dumpHeapProfile((char*)fileName.c_str());
+    std::ifstream testFile(fileName);
+    std::string header;
+    std::getline(testFile, header);
+    std::string contents((std::istreambuf_iterator<char>(testFile)), std::istreambuf_iterator<char>());
+    if(header == "heap profile: 2: 320 [2: 320] @ heap_v2/1" && contents.find("MAPPED_LIBRARIES:") != std::string::npos) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    // Every entry point leaves its own frames out, so each stack starts in allocateThrough & goes on at the same call below
+    std::cout << "Test Case: Sampled stacks start at the caller of every allocate entry point" << std::endl;
+    std::vector<void*> entryArrays;
+    for(unsigned int i = 0; i < 5; ++i) {
+        entryArrays.push_back(allocateThrough(memoryManager, i));
+    }
+    samples = memoryManager.getSampledAllocations();
+    correct = samples.size() == 2 + entryArrays.size();
+    void* callSite = nullptr;
+    for(const SampledAllocation& sample : samples) {
+        if(std::find(entryArrays.begin(), entryArrays.end(), sample.address) != entryArrays.end()) {
+            correct = correct && sample.stack.size() >= 2 && (callSite == nullptr || sample.stack[1] == callSite);
+            callSite = sample.stack.size() >= 2 ? sample.stack[1] : nullptr;
+        }
+    }
+    if(correct) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    for(void* entryArray : entryArrays) {
+        memoryManager.free(entryArray);
+    }
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray3);
+    memoryManager.shutdown();
+    return score;
+}
+
+unsigned int testAlignedAllocation()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Aligned allocation splits the leading slack back into a hole" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    uint16_t words3 = blockWords(memoryManager, 3);
+    uint16_t words8 = blockWords(memoryManager, 8);
+
+    uint8_t* start = static_cast<uint8_t*>(memoryManager.getMemoryStart());
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 3));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocateAligned(sizeof(uint64_t) * 8, 256));
+    size_t offset = (reinterpret_cast<uint8_t*>(testArray2) - start) / wordSize;
+
+    std::vector<uint16_t> correctList;
+    if(offset > words3) {
+        correctList.insert(correctList.end(), {words3, static_cast<uint16_t>(offset - words3)});
+    }
+    correctList.insert(correctList.end(), {static_cast<uint16_t>(offset + words8), static_cast<uint16_t>(numberOfWords - offset - words8)});
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    std::vector<uint16_t> holeList(list + 1, list + 1 + 2 * list[0]);
+    delete[] list;
+    if(testArray2 != nullptr && reinterpret_cast<uintptr_t>(testArray2) % 256 == 0 && offset - words3 < 32 && holeList == correctList) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "Expected: " << vectorToString(correctList) << std::endl;
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: create / destroy construct and destruct objects in place" << std::endl;
+    struct alignas(64) Tracked
+    {
+        int& alive;
+        int value;
+        Tracked(int& alive, int value) : alive(alive), value(value) { alive++; }
+        ~Tracked() { alive--; }
+    };
+    int alive = 0;
+    Tracked* tracked = memoryManager.create<Tracked>(alive, 42);
+    bool correct = tracked != nullptr && reinterpret_cast<uintptr_t>(tracked) % 64 == 0 && tracked->value == 42 && alive == 1;
+    memoryManager.destroy(tracked);
+    if(correct && alive == 0) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Standard containers allocate from the memory block with ArenaAllocator" << std::endl;
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray2);
+    {
+        std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(memoryManager)};
+        for(int i = 0; i < 100; i++) {
+            values.push_back(i);
+        }
+        uint8_t* data = reinterpret_cast<uint8_t*>(values.data());
+        correct = data >= start && data < start + numberOfWords * wordSize && values[99] == 99;
+    }
+    list = static_cast<uint16_t*>(memoryManager.getList());
+    if(correct && list[0] == 1 && list[1] == 0 && list[2] == numberOfWords) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    delete[] list;
+
+    memoryManager.shutdown();
+    return score;
+}
+
+unsigned int testAllocationHints()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Hot blocks pack at the start of memory and cold blocks at the end" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t words100 = blockWords(memoryManager, 100);
+
+    uint8_t* start = static_cast<uint8_t*>(memoryManager.getMemoryStart());
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10, AllocationHint::Hot));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 100, AllocationHint::Cold));
+    uint64_t* testArray3 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10, AllocationHint::Hot));
+    uint64_t* testArray4 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 100, AllocationHint::Cold));
+
+    std::vector<uint16_t> correctList = {static_cast<uint16_t>(2 * words10), static_cast<uint16_t>(numberOfWords - 2 * words10 - 2 * words100)};
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    std::vector<uint16_t> holeList(list + 1, list + 1 + 2 * list[0]);
+    delete[] list;
+    if(reinterpret_cast<uint8_t*>(testArray1) == start && testArray3 == testArray1 + words10
+       && reinterpret_cast<uint8_t*>(testArray2) == start + (numberOfWords - words100) * wordSize && testArray4 == testArray2 - words100
+       && holeList == correctList) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "Expected: " << vectorToString(correctList) << std::endl;
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Isolated blocks own whole cache lines" << std::endl;
+    uint8_t* testArray5 = static_cast<uint8_t*>(memoryManager.allocate(5, AllocationHint::Isolated));
+    uint8_t* testArray6 = static_cast<uint8_t*>(memoryManager.allocate(5, AllocationHint::Isolated));
+    if(testArray5 != nullptr && reinterpret_cast<uintptr_t>(testArray5) % cacheLineSize == 0
+       && testArray6 != nullptr && reinterpret_cast<uintptr_t>(testArray6) % cacheLineSize == 0
+       && (testArray6 - testArray5 >= (ptrdiff_t)cacheLineSize || testArray5 - testArray6 >= (ptrdiff_t)cacheLineSize)) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.free(testArray1);
+    memoryManager.free(testArray2);
+    memoryManager.free(testArray3);
+    memoryManager.free(testArray4);
+    memoryManager.free(testArray5);
+    memoryManager.free(testArray6);
+
+    // Holes of many sizes all over memory, each cold block still goes to the top of the highest hole that fits
+    std::cout << "Test Case: Cold blocks use the highest hole that fits in fragmented memory" << std::endl;
+    numberOfWords = 20000;
+    memoryManager.initialize(numberOfWords);
+    start = static_cast<uint8_t*>(memoryManager.getMemoryStart());
+    std::vector<void*> testArrays;
+    for(unsigned int i = 0; testArrays.empty() || testArrays.back() != nullptr; ++i) {
+        testArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * (i % 11 + 1)));
+    }
+    for(unsigned int i = 0; i < testArrays.size(); i += 2) {
+        memoryManager.free(testArrays[i]);
+    }
+    bool highest = true;
+    for(size_t sizeInWords = 1; sizeInWords <= 11; ++sizeInWords) {
+        const HoleIndex& holes = memoryManager.getHoleIndex();
+        size_t blockSize = blockWords(memoryManager, sizeInWords);
+        int64_t expected = -1;
+        for(auto& hole : holes) {
+            if(hole.second >= blockSize) {
+                expected = hole.first + hole.second - blockSize;
+            }
+        }
+        uint8_t* testArray = static_cast<uint8_t*>(memoryManager.allocate(sizeof(uint64_t) * sizeInWords, AllocationHint::Cold));
+        highest = highest && testArray != nullptr && testArray == start + expected * wordSize;
+    }
+    if(highest) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+unsigned int testPagePurge()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Freeing a large block releases its pages in an mmap arena" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1 << 17;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.setBackingStore(BackingStore::Mmap);
+    memoryManager.setPagePurge(1 << 16, 0);
+    memoryManager.initialize(numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+
+    uint8_t* testArray1 = static_cast<uint8_t*>(memoryManager.allocate(1 << 19));
+    memset(testArray1, 1, 1 << 19);
+    memoryManager.free(testArray1);
+    MemoryStats stats = memoryManager.getStats();
+
+    // Released pages come back zero-filled & are usable as before; hardened builds keep every page (it would lose its poison)
+    uint8_t* testArray2 = static_cast<uint8_t*>(memoryManager.allocate(1 << 19));
+    bool zeroed = testArray2[0] == 0 && testArray2[(1 << 19) - 1] == 0;
+    bool purged = MemoryManager::isHardened() ? stats.purges == 0 : stats.purges >= 1 && stats.purgedBytes >= (1 << 19) && zeroed;
+    memset(testArray2, 2, 1 << 19);
+    if(testArray2 == testArray1 && purged && testArray2[1000] == 2) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Pages are only released once a hole has stayed free for the decay time" << std::endl;
+    memoryManager.setPagePurge(1 << 16, 60000);
+    memoryManager.resetStats();
+    memoryManager.free(testArray2);
+    bool kept = memoryManager.getStats().purgedBytes == 0 && memoryManager.purgePages() == 0;
+    size_t released = memoryManager.purgePages(true);
+
+    // Heap arenas never release pages
+    MemoryManager heapManager(wordSize, bestFit);
+    heapManager.setPagePurge(1 << 16, 0);
+    heapManager.initialize(numberOfWords);
+    heapManager.free(heapManager.allocate(1 << 19));
+    bool releasedAll = MemoryManager::isHardened() ? released == 0 : released >= (1 << 19);
+    if(kept && releasedAll && memoryManager.getStats().purgedBytes == released && heapManager.getStats().purges == 0) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    heapManager.shutdown();
+    memoryManager.shutdown();
+    return score;
+}
+
+unsigned int testPersistentArena()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Reattaching a persistent arena picks up the blocks of the last sync" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    std::string fileName = "persistentArena";
+    std::remove(fileName.c_str());
+
+    MemoryManager memoryManager(wordSize, bestFit);
+    bool attached = memoryManager.attach((char*)fileName.c_str(), numberOfWords);
+    memoryManager.setQuarantineLimit(0);
+    uint16_t words10 = blockWords(memoryManager, 10);
+    uint16_t used = words10 + blockWords(memoryManager, 20);
+    uint64_t* testArray1 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 10));
+    uint64_t* testArray2 = static_cast<uint64_t*>(memoryManager.allocate(sizeof(uint64_t) * 20));
+    for(int i = 0; i < 20; i++) {
+        testArray2[i] = i * i;
+    }
+    memoryManager.free(testArray1);
+    memoryManager.setRoot(testArray2);
+    bool synced = memoryManager.sync();
+
+    // Blocks allocated & freed after the sync are forgotten, as after a crash
+    memoryManager.allocate(sizeof(uint64_t) * 30);
+    memoryManager.free(testArray2);
+    memoryManager.shutdown();
+
+    MemoryManager reattached(wordSize, bestFit);
+    bool reattachedOk = reattached.attach((char*)fileName.c_str(), 0);
+    uint64_t* root = static_cast<uint64_t*>(reattached.getRoot());
+    std::vector<uint16_t> correctList = {0, words10, used, static_cast<uint16_t>(numberOfWords - used)};
+    uint16_t* list = static_cast<uint16_t*>(reattached.getList());
+    std::vector<uint16_t> holeList(list + 1, list + 1 + 2 * list[0]);
+    delete[] list;
+
+    // contents are written through to the file, so hardened builds leave the poison of the free after the sync in the root block
+    bool contentsKept = root != nullptr && (MemoryManager::isHardened() || root[19] == 19 * 19);
+    if(attached && synced && reattachedOk && reattached.getMemoryLimit() == numberOfWords * wordSize && holeList == correctList
+       && root != nullptr && root == static_cast<uint64_t*>(reattached.getMemoryStart()) + words10 && contentsKept) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "Expected: " << vectorToString(correctList) << std::endl;
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Persistent arenas only attach with the word size they were made with" << std::endl;
+    reattached.shutdown();
+    MemoryManager otherWordSize(wordSize / 2, bestFit);
+    bool mismatched = otherWordSize.attach((char*)fileName.c_str(), numberOfWords);
+    bool unattachedSync = otherWordSize.sync();
+    if(!mismatched && !unattachedSync && otherWordSize.getMemoryStart() == nullptr) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::remove(fileName.c_str());
+    return score;
+}
+
+unsigned int testSharedMemoryManager()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: A block allocated in one process is read & freed in another by offset" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    std::string segmentName = "/memoryManagerTest" + std::to_string(getpid());
+    SharedMemoryManager::destroy(segmentName.c_str());
+
+    SharedMemoryManager memoryManager(wordSize);
+    bool created = memoryManager.initialize(segmentName.c_str(), numberOfWords);
+
+    // The child attaches on its own (its mapping may be at another address) & sends back the offset of its buffer
+    int channel[2];
+    bool piped = pipe(channel) == 0;
+    pid_t child = fork();
+    if(child == 0) {
+        SharedMemoryManager childManager(wordSize);
+        size_t offset = SIZE_MAX;
+        uint64_t* buffer = childManager.attach(segmentName.c_str()) ? static_cast<uint64_t*>(childManager.allocate(sizeof(uint64_t) * 100)) : nullptr;
+        if(buffer != nullptr) {
+            for(int i = 0; i < 100; i++) {
+                buffer[i] = 3 * i;
+            }
+            offset = childManager.toOffset(buffer);
+        }
+        _exit(write(channel[1], &offset, sizeof(offset)) == sizeof(offset) ? 0 : 1);
+    }
+
+    size_t offset = SIZE_MAX;
+    bool received = piped && child > 0 && read(channel[0], &offset, sizeof(offset)) == sizeof(offset);
+    waitpid(child, nullptr, 0);
+    uint64_t* buffer = static_cast<uint64_t*>(memoryManager.fromOffset(offset));
+    bool correct = created && received && buffer != nullptr && buffer[0] == 0 && buffer[99] == 3 * 99 && memoryManager.getBytesInUse() == sizeof(uint64_t) * 100;
+    memoryManager.free(buffer);
+
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    if(correct && list[0] == 1 && list[1] == 0 && list[2] == numberOfWords && memoryManager.getBytesInUse() == 0) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    delete[] list;
+    if(piped) {
+        close(channel[0]);
+        close(channel[1]);
+    }
+
+    std::cout << "Test Case: Segments are created once & only attach with their word size" << std::endl;
+    SharedMemoryManager otherManager(wordSize);
+    SharedMemoryManager otherWordSize(wordSize / 2);
+    bool createdTwice = otherManager.initialize(segmentName.c_str(), numberOfWords);
+    bool mismatched = otherWordSize.attach(segmentName.c_str());
+    bool destroyed = SharedMemoryManager::destroy(segmentName.c_str());
+    bool attachedAfterDestroy = otherManager.attach(segmentName.c_str());
+    if(!createdTwice && !mismatched && destroyed && !attachedAfterDestroy && memoryManager.allocate(8) != nullptr) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+
+// Stores through a pointer the hardened build has marked unaddressable, so the manager's own checks (not ASan) are what notice
+__attribute__((no_sanitize_address)) static void storeUnchecked(uint8_t* address, uint8_t value)
+{
+    *address = value;
+}
+
+unsigned int testHardenedBuild()
+{
+    unsigned int score = 0;
+    bool hardened = MemoryManager::isHardened();
+    std::cout << "Test Case: A write past the end of a block is caught by its canary (only in a hardened build) - " << (hardened ? "hardened" : "default") << " build" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 256;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+
+    std::vector<std::string> problems;
+    memoryManager.setCorruptionHandler([&](const char* problem, void*) { problems.push_back(problem); });
+
+    // One byte past the block lands in its last word, so only the canary can notice
+    uint8_t* block = static_cast<uint8_t*>(memoryManager.allocate(20));
+    storeUnchecked(block + 20, 1);
+    memoryManager.free(block);
+
+    std::vector<std::string> expected;
+    if(hardened) {
+        expected = {"write past end of block"};
+    }
+    if(problems == expected) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Double frees & writes after free are caught (only in a hardened build)" << std::endl;
+    problems.clear();
+    memoryManager.free(block);
+
+    // The quarantined block is checked when the quarantine is emptied to make room for a large block
+    storeUnchecked(block, 7);
+    void* large = memoryManager.allocate(wordSize * (numberOfWords - 4));
+
+    if(hardened) {
+        expected = {"double free", "write after free"};
+    }
+    if(problems == expected && large != nullptr) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Freed blocks are only handed out again once the quarantine releases them (only in a hardened build)" << std::endl;
+    memoryManager.free(large);
+    memoryManager.initialize(numberOfWords);
+    problems.clear();
+    void* first = memoryManager.allocate(sizeof(uint64_t) * 2);
+    memoryManager.free(first);
+    void* second = memoryManager.allocate(sizeof(uint64_t) * 2);
+    memoryManager.free(second);
+
+    // Quarantining 31 more words goes past 1/8 of memory (32 words), which releases the two oldest blocks
+    memoryManager.free(memoryManager.allocate(sizeof(uint64_t) * 30));
+    void* third = memoryManager.allocate(sizeof(uint64_t) * 2);
+
+    bool reused = hardened ? second != first : second == first;
+    if(reused && first != nullptr && third == first && problems.empty()) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+    memoryManager.free(third);
+
+    std::cout << "Test Case: Sizes that wrap around when rounded up to words are rejected" << std::endl;
+    problems.clear();
+    uint8_t* smallBlock = static_cast<uint8_t*>(memoryManager.allocate(sizeof(uint64_t)));
+    bool rejected = memoryManager.allocate(SIZE_MAX - 2) == nullptr && memoryManager.allocate(SIZE_MAX) == nullptr &&
+                    memoryManager.allocateAligned(SIZE_MAX - 2, 64) == nullptr && memoryManager.allocateHandle(SIZE_MAX - 2) == nullHandle &&
+                    memoryManager.reallocate(smallBlock, SIZE_MAX - 2) == nullptr;
+    std::vector<size_t> sizes = {SIZE_MAX - 2, SIZE_MAX - 2, sizeof(uint64_t)};
+    std::vector<void*> batch;
+    rejected = rejected && memoryManager.allocateBatch(sizes, batch) == 1 && batch[2] != nullptr;
+    memoryManager.free(batch[2]);
+    memoryManager.free(smallBlock);
+    if(rejected && problems.empty()) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Blocks used within their size are never reported" << std::endl;
+    problems.clear();
+    std::vector<uint32_t*> arrays;
+    for(int i = 0; i < 20; i++) {
+        arrays.push_back(static_cast<uint32_t*>(memoryManager.allocate(sizeof(uint32_t) * (i + 1))));
+        for(int j = 0; arrays.back() != nullptr && j <= i; j++) {
+            arrays.back()[j] = j;
+        }
+    }
+    for(int i = 0; i < 20; i += 2) {
+        arrays[i] = static_cast<uint32_t*>(memoryManager.reallocate(arrays[i], sizeof(uint32_t) * (i + 9)));
+    }
+    bool kept = true;
+    for(int i = 0; i < 20; i++) {
+        kept = kept && arrays[i] != nullptr && arrays[i][i] == (uint32_t)i;
+        memoryManager.free(arrays[i]);
+    }
+    if(problems.empty() && kept && memoryManager.allocate(wordSize * (numberOfWords - 4)) != nullptr) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+unsigned int testHoleListView()
+{
+    unsigned int score = 0;
+    std::cout << "Test Case: Hole list view matches getList & only changes with the holes" << std::endl;
+    unsigned int wordSize = 8;
+    size_t numberOfWords = 1000;
+    MemoryManager memoryManager(wordSize, bestFit);
+    memoryManager.initialize(numberOfWords);
+
+    std::vector<void*> testArrays;
+    for(unsigned int i = 0; i < 20; ++i) {
+        testArrays.push_back(memoryManager.allocate(sizeof(uint64_t) * (i % 5 + 1)));
+    }
+    for(unsigned int i = 0; i < testArrays.size(); i += 2) {
+        memoryManager.free(testArrays[i]);
+    }
+
+    HoleListView view = memoryManager.getHoleListView();
+    const uint16_t* viewList = static_cast<const uint16_t*>(view.list);
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    bool matches = viewList != nullptr && viewList[0] == list[0] && std::equal(list, list + 1 + list[0] * 2, viewList);
+    delete[] list;
+
+    // Nothing changed, so the same snapshot is handed back
+    memoryManager.getStats();
+    HoleListView again = memoryManager.getHoleListView();
+    if(matches && again.list == view.list && again.generation == view.generation && memoryManager.getHoleGeneration() == view.generation) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    std::cout << "Test Case: Replaying hole changes brings a snapshot up to date" << std::endl;
+    std::map<size_t, size_t> snapshot;
+    for(uint16_t i = 0; i < viewList[0]; i++) {
+        snapshot[viewList[1 + i * 2]] = viewList[2 + i * 2];
+    }
+    uint64_t generation = view.generation;
+
+    memoryManager.free(testArrays[1]);
+    memoryManager.allocate(sizeof(uint64_t) * 3);
+    memoryManager.free(testArrays[7]);
+    bool replayed = memoryManager.forEachHoleChange(generation, [&](const HoleChange& change) {
+        if(change.added) {
+            snapshot[change.offset] = change.size;
+        }
+        else {
+            snapshot.erase(change.offset);
+        }
+        generation = change.generation;
+    });
+
+    view = memoryManager.getHoleListView();
+    viewList = static_cast<const uint16_t*>(view.list);
+    std::map<size_t, size_t> current;
+    for(uint16_t i = 0; i < viewList[0]; i++) {
+        current[viewList[1 + i * 2]] = viewList[2 + i * 2];
+    }
+
+    // Changes older than the journal are gone, the poller reads the view again
+    uint64_t old = view.generation;
+    for(unsigned int i = 0; i < 3000; ++i) {
+        memoryManager.free(memoryManager.allocate(sizeof(uint64_t)));
+    }
+    bool expired = !memoryManager.forEachHoleChange(old, [](const HoleChange&) {});
+    if(replayed && generation == view.generation && snapshot == current && expired) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        score++;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+    }
+
+    memoryManager.shutdown();
+    return score;
+}
+
+std::string vectorToString(const std::vector<uint16_t>& vector)
+{
+    std::string vectorString = "";
+
+    vectorString += "[" + std::to_string(vector[0]) + ", " + std::to_string(vector[1]);
+    for (int i = 2; i < vector.size(); i +=2)
+    {
+        vectorString += "] - [" + std::to_string(vector[i]) + ", " + std::to_string(vector[i + 1]);
+    }
+    vectorString += "]";
+
+    return vectorString;
+}
+
+
+unsigned int testGetBitmap(MemoryManager& memoryManager, uint16_t correctBitmapLength, std::vector<uint8_t> correctBitmap)
+{
+    unsigned int score = 0;
+    uint8_t* bitmap = static_cast<uint8_t*>(memoryManager.getBitmap());
+    uint8_t* bitmapEntryPoint = bitmap;
+
+    uint8_t lowerByte = *bitmap++;
+    uint8_t higherByte = *bitmap++;
+    uint16_t byteStreamLength = (higherByte << 8) | lowerByte;
+
+    std::cout << "Testing getBitmap" << std::endl;
+    std::cout << "Expected: " << std::endl;
+    std::cout << "[0x" << std::hex << (int)correctBitmap[0];
+
+    for(uint16_t i = 1; i < correctBitmap.size(); ++i) {
+        std::cout << ", 0x" << std::hex << (int)correctBitmap[i];
+    }
+    std::cout << "]" << std::endl;
+
+
+    std::cout << "\n";
+    std::cout << "Got:"  << std::endl;
+    std::cout << "[0x" << std::hex << (int)bitmap[0];
+    for(uint16_t i = 1; i < byteStreamLength; ++i) {
+        std::cout << ", 0x" << std::hex << (int)bitmap[i];
+    }
+    std::cout << "]" << std::endl;
+
+    for(uint16_t i = 0; i < byteStreamLength; ++i) {
+        if(bitmap[i] != correctBitmap[i]) {
+            delete [] bitmapEntryPoint;
+            std::cout << "[INCORRECT]\n" << std::endl;
+            return score;
+        }
+    }
+
+    ++score;
+    delete [] bitmapEntryPoint;
+    std::cout << "[CORRECT]\n" << std::endl;
+    return score;
+}
+
+
+unsigned int testGetList(MemoryManager& memoryManager, uint16_t correctListLength, std::vector<uint16_t> correctList)
+{
+    unsigned int score = 0;
+    std::cout << std::dec << std::endl;
+    uint16_t* list = static_cast<uint16_t*>(memoryManager.getList());
+    uint16_t* listEntryPoint = list;
+
+    uint16_t listLength = *list++;
+
+    uint16_t bytesPerEntry = 2;
+    uint16_t entriesInList = listLength * bytesPerEntry;
+
+    std::cout << "Testing getList" << std::endl;
+    std::cout << "Expected: " << std::endl;
+    std::cout << std::dec << "[" << correctList[0];
+    for(uint16_t i = 1; i < correctList.size(); ++i) {
+        std::cout <<"] - [" << correctList[i];
+    }
+    std::cout << "]" << std::endl;
+
+
+    std::cout << "\n";
+    std::cout << "Got:"  << std::endl;
+    std::cout << std::dec << "[" << list[0];
+    for(uint16_t i = 1; i < entriesInList; ++i) {
+        std::cout <<"] - [" << list[i];
+    }
+    std::cout << "]" << std::endl;
+
+    for(uint16_t i = 0; i < entriesInList; ++i) {
+        if(list[i] != correctList[i]) {
+            delete [] listEntryPoint;
+            std::cout << "[INCORRECT]\n" << std::endl;
+            return score;
+        }
+    }
+
+    ++score;
+
+    delete [] listEntryPoint;
+    std::cout << "[CORRECT]\n" << std::endl;
+    return score;
+}
+
+unsigned int testGetWordSize(MemoryManager& memoryManager, size_t correctWordSize)
+{
+    std::cout << "Testing getWordSize" << std::endl;
+    std::cout << "Expected: " << correctWordSize << std::endl;
+    std::cout << "Got:" << memoryManager.getWordSize() << std::endl;
+    if(memoryManager.getWordSize() == correctWordSize) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        return 1;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+        return 0;
+    }
+}
+
+unsigned int testGetMemoryLimit(MemoryManager& memoryManager, size_t correctMemoryLimit)
+{
+    std::cout << "Testing getMemoryLimit" << std::endl;
+    std::cout << "Expected: " << correctMemoryLimit << std::endl;
+    std::cout << "Got:" << memoryManager.getMemoryLimit() << std::endl;
+    if(memoryManager.getMemoryLimit() == correctMemoryLimit) {
+        std::cout << "[CORRECT]\n" << std::endl;
+        return 1;
+    }
+    else {
+        std::cout << "[INCORRECT]\n" << std::endl;
+        return 0;
+    }
+}
+
+unsigned int testDumpMemoryMap(MemoryManager& memoryManager, std::string fileName, std::string correctFileContents)
+{
+    std::cout << "Testing dumpMemoryMap" << std::endl;
+  
+    memoryManager.dumpMemoryMap((char*)fileName.c_str());
+    std::ifstream testFile(fileName);
+    if (testFile.is_open()) {
+        std::string line;
+        std::getline(testFile, line);
+        testFile.close();
+        std::cout << "Expected: " << correctFileContents << std::endl;
+        std::cout << "Got:" << line << std::endl;
+        if(line == correctFileContents) {
+            std::cout << "[CORRECT]\n" << std::endl;
+            return 1;
+        }
+        else {
+            std::cout << "[INCORRECT]\n" << std::endl;
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// Words a block of sizeInWords words takes (more than sizeInWords in hardened builds, which add a guard), so layouts can be written for every build
+size_t blockWords(MemoryManager& memoryManager, size_t sizeInWords)
+{
+    return memoryManager.wordsFor(sizeInWords * memoryManager.getWordSize());
+}
+
+// Allocates 10 words through one allocate entry point (never inlined, so its frame is on the stack of the sample)
+__attribute__((noinline)) void* allocateThrough(MemoryManager& memoryManager, unsigned int entryPoint)
+{
+    std::vector<void*> out;
+    switch(entryPoint) {
+        case 0: return memoryManager.allocate(sizeof(uint64_t) * 10);
+        case 1: return memoryManager.allocate(sizeof(uint64_t) * 10, AllocationHint::Isolated);
+        case 2: return memoryManager.create<std::array<uint64_t, 10>>();
+        case 3: return memoryManager.reallocate(nullptr, sizeof(uint64_t) * 10);
+        default:
+            memoryManager.allocateBatch({sizeof(uint64_t) * 10}, out);
+            return out[0];
+    }
+}
+
+// Bitmap getBitmap returns for numberOfWords words whose holes are the (offset, length) pairs in holes
+template <typename Offset>
+std::vector<uint8_t> bitmapOf(size_t numberOfWords, const std::vector<Offset>& holes)
+{
+    std::vector<uint8_t> bitmap((numberOfWords + 7) / 8, 0);
+    for(size_t i = 0; i < numberOfWords; ++i) {
+        bitmap[i / 8] |= 1 << (i % 8);
+    }
+    for(size_t i = 0; i + 1 < holes.size(); i += 2) {
+        for(size_t word = holes[i]; word < holes[i] + holes[i + 1]; ++word) {
+            bitmap[word / 8] &= ~(1 << (word % 8));
+        }
+    }
+    return bitmap;
+}
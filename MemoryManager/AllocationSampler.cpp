@@ -0,0 +1,212 @@
+#include "AllocationSampler.h"
+#include "MemoryMapDump.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+/*--------------------------------------------|
+|    AllocationSampler Class Definitions      |
+|--------------------------------------------*/
+
+/* SET INTERVAL:
+Sets the mean bytes between samples, 0 turns sampling off
+*/
+void AllocationSampler::setInterval(size_t bytes)
+{
+    interval = bytes;
+    if (bytes != 0)
+    {
+        profileInterval = bytes;
+    }
+}
+
+/* GET INTERVAL:
+Returns the mean bytes between samples, 0 when off
+*/
+size_t AllocationSampler::getInterval() const
+{
+    return interval;
+}
+
+/* NEXT COUNTDOWN:
+Draws the bytes until the next sample from an exponential distribution with a mean of interval bytes
+*/
+int64_t AllocationSampler::nextCountdown()
+{
+    if (interval == 0)
+    {
+        return INT64_MAX;
+    }
+
+    // -ln(u) * interval, u uniform in (0, 1]
+    double uniform = (rng() >> 11) * (1.0 / 9007199254740992.0);
+    double bytes = -std::log(1.0 - uniform) * interval;
+    return bytes >= (double)INT64_MAX ? INT64_MAX : (int64_t)bytes;
+}
+
+/* RECORD:
+Tracks a sampled block with the current call stack, from the frame caller is in (the return address of the allocator's entry point) outwards
+The allocator's own frames are left out however many there are or were inlined; only record's frame is if caller is not on the stack
+*/
+void AllocationSampler::record(void *address, size_t sizeInBytes, const void *caller)
+{
+    void *frames[maxFrames];
+    int depth = backtrace(frames, maxFrames);
+    int first = std::min(depth, 1);
+    for (int i = 1; i < depth; i++)
+    {
+        if (frames[i] == caller)
+        {
+            first = i;
+            break;
+        }
+    }
+
+    SampledAllocation &sample = samples[address];
+    sample.address = address;
+    sample.sizeInBytes = sizeInBytes;
+    sample.stack.assign(frames + first, frames + depth);
+}
+
+/* FORGET:
+Stops tracking a freed block (no-op if it was not sampled)
+*/
+void AllocationSampler::forget(void *address)
+{
+    samples.erase(address);
+}
+
+/* FORGET RANGE:
+Stops tracking every sampled block starting in [start, start + bytes)
+*/
+void AllocationSampler::forgetRange(void *start, size_t bytes)
+{
+    for (auto sample = samples.begin(); sample != samples.end();)
+    {
+        uint8_t *address = static_cast<uint8_t *>(sample->first);
+        if (address >= static_cast<uint8_t *>(start) && address < static_cast<uint8_t *>(start) + bytes)
+        {
+            sample = samples.erase(sample);
+        }
+        else
+        {
+            ++sample;
+        }
+    }
+}
+
+/* MOVE:
+Keeps tracking a sampled block under its new address (no-op if it was not sampled)
+*/
+void AllocationSampler::move(void *from, void *to)
+{
+    auto found = samples.find(from);
+    if (found == samples.end())
+    {
+        return;
+    }
+
+    SampledAllocation sample = std::move(found->second);
+    samples.erase(found);
+    sample.address = to;
+    samples[to] = std::move(sample);
+}
+
+/* CLEAR:
+Stops tracking every block
+*/
+void AllocationSampler::clear()
+{
+    samples.clear();
+}
+
+/* COUNT:
+Returns the number of live sampled blocks
+*/
+size_t AllocationSampler::count() const
+{
+    return samples.size();
+}
+
+/* GET SAMPLES:
+Returns a copy of the live sampled blocks, in no particular order
+*/
+std::vector<SampledAllocation> AllocationSampler::getSamples() const
+{
+    std::vector<SampledAllocation> copies;
+    copies.reserve(samples.size());
+    for (auto &sample : samples)
+    {
+        copies.push_back(sample.second);
+    }
+    return copies;
+}
+
+/* WRITE PROFILE:
+Writes "heap profile: <objects>: <bytes> [<objects>: <bytes>] @ heap_v2/<interval>", one such line per distinct stack followed by its
+return addresses, then the process mappings pprof symbolizes them with; counts are raw samples, which pprof scales by the interval
+*/
+int AllocationSampler::writeProfile(int fd) const
+{
+    struct Totals
+    {
+            size_t objects = 0;
+            size_t bytes = 0;
+    };
+    std::map<std::vector<void *>, Totals> byStack;
+    Totals total;
+    for (auto &sample : samples)
+    {
+        Totals &totals = byStack[sample.second.stack];
+        totals.objects++;
+        totals.bytes += sample.second.sizeInBytes;
+        total.objects++;
+        total.bytes += sample.second.sizeInBytes;
+    }
+
+    // Only live blocks are tracked, so the in-use & allocated counts are the same
+    auto counts = [](const Totals &totals) {
+        std::string pair = std::to_string(totals.objects) + ": " + std::to_string(totals.bytes);
+        return pair + " [" + pair + "]";
+    };
+
+    std::string profile = "heap profile: " + counts(total) + " @ heap_v2/" + std::to_string(profileInterval) + "\n";
+    for (auto &stack : byStack)
+    {
+        profile += counts(stack.second) + " @";
+        for (void *frame : stack.first)
+        {
+            char address[24];
+            snprintf(address, sizeof(address), " %p", frame);
+            profile += address;
+        }
+        profile += "\n";
+    }
+    profile += "\nMAPPED_LIBRARIES:\n";
+    if (writeFully(fd, profile.data(), profile.size()) == -1)
+    {
+        return -1;
+    }
+
+    // Copy the mappings as they are now (the profile is only valid for this process image)
+    int maps = open("/proc/self/maps", O_RDONLY);
+    if (maps < 0)
+    {
+        return 0;
+    }
+    char buffer[4096];
+    ssize_t got;
+    int result = 0;
+    while (result == 0 && (got = read(maps, buffer, sizeof(buffer))) > 0)
+    {
+        result = writeFully(fd, buffer, got);
+    }
+    close(maps);
+    return result;
+}
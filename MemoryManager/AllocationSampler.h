@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// A live allocation picked by the sampler, with the call stack that allocated it (innermost frame first)
+struct SampledAllocation
+{
+        void* address;
+        size_t sizeInBytes;                           // bytes requested
+        std::vector<void*> stack;                     // return addresses, starting at the caller of allocate
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  AllocationSampler Class Declaration                                           |
+|   - Picks about one allocation per interval bytes: the gap between samples is  |
+|     drawn from an exponential distribution with that mean, so every byte has  |
+|     the same chance of being sampled & periodic patterns do not alias          |
+|   - Keeps each sampled block (& its stack) until it is freed                   |
+|   - The owner keeps the byte countdown itself, so unsampled allocations only   |
+|     pay a subtraction & one branch                                             |
+|--------------------------------------------------------------------------------|
+*/
+class AllocationSampler
+{
+ private:
+        static const unsigned maxFrames = 64;         // deepest stack captured
+        size_t interval = 0;                          // mean bytes between samples, 0 when off
+        size_t profileInterval = 1;                   // last interval that was not 0 (the rate pprof scales samples by)
+        std::mt19937_64 rng{0x5eed};
+        std::unordered_map<void*, SampledAllocation> samples;   // live sampled blocks by address
+
+ public:
+        // Sets the mean bytes between samples, 0 turns sampling off (blocks already sampled stay tracked)
+        void setInterval(size_t bytes);
+        size_t getInterval() const;
+
+        // Bytes to allocate before the next sample (INT64_MAX when off)
+        int64_t nextCountdown();
+
+        // Mutators (used by MemoryManager only)
+        void record(void* address, size_t sizeInBytes, const void* caller);
+        void forget(void* address);
+        void forgetRange(void* start, size_t bytes);  // forgets every sample in [start, start + bytes)
+        void move(void* from, void* to);
+        void clear();
+
+        // Accessors
+        size_t count() const;
+        std::vector<SampledAllocation> getSamples() const;
+
+        // Writes the live samples as a pprof legacy heap profile (heap_v2 format, stacks with the same frames are merged), returns 0 / -1 on error
+        int writeProfile(int fd) const;
+};
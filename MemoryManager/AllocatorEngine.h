@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Allocator Engine Types                                                        |
+|     - HoleList: coalescing list of holes searched by the allocator function    |
+|       (the default, and the only engine that uses setAllocator)               |
+|     - Buddy: power-of-two blocks with per-order free bitmaps, allocate & free  |
+|       take O(log N) regardless of fragmentation                                |
+|     - Tlsf: two-level segregated fit, allocate & free take O(1) (up to         |
+|       TlsfEngine::maxWords words)                                              |
+|--------------------------------------------------------------------------------|
+*/
+enum class EngineType { HoleList, Buddy, Tlsf };
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  AllocatorEngine Interface Declaration                                         |
+|   - Decides where blocks go in a MemoryManager's memory block                  |
+|   - Works in word offsets, the MemoryManager keeps the occupancy bitmap and    |
+|     translates to addresses                                                    |
+|   - A block may be larger than requested (blockSize reports how large)         |
+|--------------------------------------------------------------------------------|
+*/
+class AllocatorEngine
+{
+ public:
+        virtual ~AllocatorEngine() = default;
+
+        // Word offset of a new block of at least sizeInWords words, -1 if none fits
+        virtual int64_t allocate(size_t sizeInWords) = 0;
+
+        // Same as allocate, with the offset % alignInWords == phase (alignInWords is a power of two, phase < alignInWords)
+        virtual int64_t allocateAligned(size_t sizeInWords, size_t alignInWords, size_t phase) = 0;
+
+        // Frees the block starting at offset, returns its size in words (0 if offset is not an allocated block)
+        virtual size_t free(size_t offset) = 0;
+
+        // Size in words of the allocated block starting at offset (0 if offset is not an allocated block)
+        virtual size_t blockSize(size_t offset) const = 0;
+
+        // Calls visit(word offset, size in words) for each free range, in ascending offset order
+        virtual void forEachHole(const std::function<void(size_t offset, size_t size)>& visit) const = 0;
+};
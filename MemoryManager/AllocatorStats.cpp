@@ -0,0 +1,261 @@
+#include "AllocatorStats.h"
+
+#include <chrono>
+
+// Helper function: adds n to a counter only the manager's thread writes (no locked read-modify-write)
+template <typename T>
+static inline void bump(std::atomic<T> &counter, T n)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Helper function: index of the highest set bit of value (0 for 0), capped at count - 1
+static inline unsigned log2Bucket(uint64_t value, unsigned count)
+{
+    unsigned bucket = value == 0 ? 0 : 63 - __builtin_clzll(value);
+    return bucket < count ? bucket : count - 1;
+}
+
+/*--------------------------------------------|
+|      AllocatorStats Class Definitions       |
+|--------------------------------------------*/
+
+/* NOW:
+Returns monotonic clock time in nanoseconds
+*/
+uint64_t AllocatorStats::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* START TIMING:
+Counts down to the next call to time; returns the clock for that call & 0 for every other (the histograms are only fed timed calls)
+*/
+uint64_t AllocatorStats::startTiming()
+{
+    if (latencySampling == 0 || --callsUntilTimed != 0)
+    {
+        return 0;
+    }
+    callsUntilTimed = latencySampling;
+    return now();
+}
+
+/* SET LATENCY SAMPLING:
+Times one allocate / free in everyNthCall (1 times every call, 0 turns timing off); counters are not affected
+*/
+void AllocatorStats::setLatencySampling(unsigned everyNthCall)
+{
+    latencySampling = everyNthCall;
+    callsUntilTimed = everyNthCall;
+}
+
+/* RECORD ALLOCATION:
+Counts an allocation of sizeInWords words in its size class, & as a success or failure
+*/
+void AllocatorStats::recordAllocation(size_t sizeInWords, bool succeeded)
+{
+    bump<uint64_t>(succeeded ? allocations : failedAllocations, 1);
+    bump<uint64_t>(sizeClassCounts[log2Bucket(sizeInWords, MemoryStats::sizeClassCount)], 1);
+}
+
+/* RECORD FREE:
+Counts a freed block
+*/
+void AllocatorStats::recordFree()
+{
+    bump<uint64_t>(frees, 1);
+}
+
+/* RECORD SPLIT:
+Counts a node split
+*/
+void AllocatorStats::recordSplit()
+{
+    bump<uint64_t>(splits, 1);
+}
+
+/* RECORD MERGE:
+Counts a hole merged with its neighbour
+*/
+void AllocatorStats::recordMerge()
+{
+    bump<uint64_t>(merges, 1);
+}
+
+/* RECORD PURGE:
+Counts a page range of bytes handed back to the kernel
+*/
+void AllocatorStats::recordPurge(size_t bytes)
+{
+    bump<uint64_t>(purges, 1);
+    bump<uint64_t>(purgedBytes, bytes);
+}
+
+/* RECORD USED:
+Adds bytes taken out of holes to bytesInUse, raising the peak if it is passed
+*/
+void AllocatorStats::recordUsed(size_t bytes)
+{
+    size_t inUse = bytesInUse.load(std::memory_order_relaxed) + bytes;
+    bytesInUse.store(inUse, std::memory_order_relaxed);
+    if (inUse > peakBytesInUse.load(std::memory_order_relaxed))
+    {
+        peakBytesInUse.store(inUse, std::memory_order_relaxed);
+    }
+}
+
+/* RECORD RELEASED:
+Takes bytes returned to holes off bytesInUse
+*/
+void AllocatorStats::recordReleased(size_t bytes)
+{
+    bytesInUse.store(bytesInUse.load(std::memory_order_relaxed) - bytes, std::memory_order_relaxed);
+}
+
+/* RECORD ALLOCATE LATENCY:
+Counts an allocate call that took the given time
+*/
+void AllocatorStats::recordAllocateLatency(uint64_t nanoseconds)
+{
+    bump<uint64_t>(allocateLatency[log2Bucket(nanoseconds, MemoryStats::latencyBucketCount)], 1);
+}
+
+/* RECORD FREE LATENCY:
+Counts a free call that took the given time
+*/
+void AllocatorStats::recordFreeLatency(uint64_t nanoseconds)
+{
+    bump<uint64_t>(freeLatency[log2Bucket(nanoseconds, MemoryStats::latencyBucketCount)], 1);
+}
+
+/* RESET:
+Clears every counter & histogram; bytesInUse is a level rather than a count, so it stays & the peak restarts from it
+*/
+void AllocatorStats::reset()
+{
+    for (std::atomic<uint64_t> *counter : {&allocations, &failedAllocations, &frees, &splits, &merges, &purges, &purgedBytes})
+    {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (auto &count : sizeClassCounts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+    for (unsigned i = 0; i < MemoryStats::latencyBucketCount; i++)
+    {
+        allocateLatency[i].store(0, std::memory_order_relaxed);
+        freeLatency[i].store(0, std::memory_order_relaxed);
+    }
+    peakBytesInUse.store(bytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/* CLEAR:
+Clears every counter & histogram along with bytesInUse & its peak
+*/
+void AllocatorStats::clear()
+{
+    bytesInUse.store(0, std::memory_order_relaxed);
+    reset();
+}
+
+/* SNAPSHOT:
+Copies the counters & histograms into stats
+*/
+void AllocatorStats::snapshot(MemoryStats &stats) const
+{
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.failedAllocations = failedAllocations.load(std::memory_order_relaxed);
+    stats.frees = frees.load(std::memory_order_relaxed);
+    stats.splits = splits.load(std::memory_order_relaxed);
+    stats.merges = merges.load(std::memory_order_relaxed);
+    stats.purges = purges.load(std::memory_order_relaxed);
+    stats.purgedBytes = purgedBytes.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < MemoryStats::sizeClassCount; i++)
+    {
+        stats.sizeClassCounts[i] = sizeClassCounts[i].load(std::memory_order_relaxed);
+    }
+    stats.bytesInUse = bytesInUse.load(std::memory_order_relaxed);
+    stats.peakBytesInUse = peakBytesInUse.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < MemoryStats::latencyBucketCount; i++)
+    {
+        stats.allocateLatency[i] = allocateLatency[i].load(std::memory_order_relaxed);
+        stats.freeLatency[i] = freeLatency[i].load(std::memory_order_relaxed);
+    }
+    stats.latencySampleInterval = latencySampling;
+}
+
+/* GET ALLOCATIONS:
+Returns the number of successful allocations
+*/
+uint64_t AllocatorStats::getAllocations() const
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+/* GET FREES:
+Returns the number of blocks freed
+*/
+uint64_t AllocatorStats::getFrees() const
+{
+    return frees.load(std::memory_order_relaxed);
+}
+
+/* GET BYTES IN USE:
+Returns the bytes of the memory block not in holes
+*/
+size_t AllocatorStats::getBytesInUse() const
+{
+    return bytesInUse.load(std::memory_order_relaxed);
+}
+
+/* GET PEAK BYTES IN USE:
+Returns the highest bytesInUse since the last reset
+*/
+size_t AllocatorStats::getPeakBytesInUse() const
+{
+    return peakBytesInUse.load(std::memory_order_relaxed);
+}
+
+// Helper function: writes the non-empty entries of a log2 histogram as "name [low, high): count" lines
+static void writeHistogram(std::ostream &out, const char *name, const char *unit, const uint64_t *counts, unsigned count)
+{
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (counts[i] != 0)
+        {
+            out << name << " [" << (1ULL << i) << ", ";
+            if (i + 1 < 64)
+            {
+                out << (1ULL << (i + 1));
+            }
+            else
+            {
+                out << "18446744073709551616";        // 2^64 does not fit in 64 bits
+            }
+            out << ") " << unit << ": " << counts[i] << "\n";
+        }
+    }
+}
+
+std::ostream &operator<<(std::ostream &out, const MemoryStats &stats)
+{
+    out << "allocations: " << stats.allocations << "\n"
+        << "failed allocations: " << stats.failedAllocations << "\n"
+        << "frees: " << stats.frees << "\n"
+        << "splits: " << stats.splits << "\n"
+        << "merges: " << stats.merges << "\n"
+        << "purges: " << stats.purges << "\n"
+        << "purged bytes: " << stats.purgedBytes << "\n"
+        << "bytes in use: " << stats.bytesInUse << "\n"
+        << "peak bytes in use: " << stats.peakBytesInUse << "\n"
+        << "free bytes: " << stats.freeBytes << "\n"
+        << "holes: " << stats.holeCount << "\n"
+        << "largest hole: " << stats.largestHole << "\n"
+        << "fragmentation: " << stats.fragmentation << "\n"
+        << "latency sample interval: " << stats.latencySampleInterval << "\n";
+    writeHistogram(out, "size class", "words", stats.sizeClassCounts, MemoryStats::sizeClassCount);
+    writeHistogram(out, "allocate", "ns", stats.allocateLatency, MemoryStats::latencyBucketCount);
+    writeHistogram(out, "free", "ns", stats.freeLatency, MemoryStats::latencyBucketCount);
+    return out;
+}
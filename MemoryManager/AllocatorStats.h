@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Memory Stats Struct                                                           |
+|     - Snapshot of a MemoryManager's counters & holes (see getStats)            |
+|     - Size class k counts requests of [2^k, 2^(k+1)) words                     |
+|     - Latency bucket k counts calls that took [2^k, 2^(k+1)) nanoseconds (the  |
+|       last bucket also holds everything slower); only one call in            |
+|       latencySampleInterval is timed, so multiply by it to estimate totals     |
+|     - Fragmentation is 1 - largestHole / freeBytes (0 when nothing is free):   |
+|       0 means all free memory is one hole, near 1 means it is in many pieces   |
+|--------------------------------------------------------------------------------|
+*/
+struct MemoryStats
+{
+        static const unsigned sizeClassCount = 64;
+        static const unsigned latencyBucketCount = 32;
+
+        uint64_t allocations = 0;                     // successful allocations
+        uint64_t failedAllocations = 0;               // allocations that returned nullptr (zero sizes aside)
+        uint64_t frees = 0;                           // blocks freed
+        uint64_t splits = 0;                          // nodes split in the hole list
+        uint64_t merges = 0;                          // holes merged with a neighbouring hole
+        uint64_t sizeClassCounts[sizeClassCount] = {};    // allocations (failed ones too) by size class
+        uint64_t purges = 0;                          // page ranges handed back to the kernel (see setPagePurge)
+        uint64_t purgedBytes = 0;                     // bytes in those ranges
+
+        size_t bytesInUse = 0;                        // bytes of the memory block not in holes
+        size_t peakBytesInUse = 0;                    // highest bytesInUse since initialize / resetStats
+        size_t freeBytes = 0;                         // bytes in holes
+        size_t holeCount = 0;
+        size_t largestHole = 0;                       // bytes in the largest hole
+        double fragmentation = 0;
+
+        uint64_t allocateLatency[latencyBucketCount] = {};  // timed allocate calls by duration
+        uint64_t freeLatency[latencyBucketCount] = {};      // timed free calls (that freed a block) by duration
+        unsigned latencySampleInterval = 0;           // calls per timed call (0 = timing off)
+};
+
+// Writes the snapshot as readable text, one figure per line (empty classes & buckets are left out)
+std::ostream& operator<<(std::ostream& out, const MemoryStats& stats);
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  AllocatorStats Class Declaration                                              |
+|   - Always-on counters of a MemoryManager                                      |
+|   - Written only by the thread using the manager (or under its lock), so each  |
+|     update is a relaxed load & store with no locked instruction                |
+|   - Counters are relaxed atomics, so any thread may read them while the       |
+|     manager is in use (figures may be a few calls behind)                      |
+|   - Latencies need two clock reads, so only every Nth allocate / free is      |
+|     timed (N = defaultLatencySampling unless changed, 1 times every call)     |
+|--------------------------------------------------------------------------------|
+*/
+class AllocatorStats
+{
+ private:
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> failedAllocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> splits{0};
+        std::atomic<uint64_t> merges{0};
+        std::atomic<uint64_t> sizeClassCounts[MemoryStats::sizeClassCount] = {};
+        std::atomic<uint64_t> purges{0};
+        std::atomic<uint64_t> purgedBytes{0};
+        std::atomic<size_t> bytesInUse{0};
+        std::atomic<size_t> peakBytesInUse{0};
+        std::atomic<uint64_t> allocateLatency[MemoryStats::latencyBucketCount] = {};
+        std::atomic<uint64_t> freeLatency[MemoryStats::latencyBucketCount] = {};
+        unsigned latencySampling = defaultLatencySampling;    // calls per timed call (0 = never timed)
+        unsigned callsUntilTimed = defaultLatencySampling;    // calls left before the next timed one
+
+ public:
+        static const unsigned defaultLatencySampling = 64;
+
+        // Monotonic clock in nanoseconds, for the latency histograms
+        static uint64_t now();
+
+        // Returns now() if the calling allocate / free is one to time, 0 otherwise (no clock read)
+        uint64_t startTiming();
+        void setLatencySampling(unsigned everyNthCall);
+
+        // Mutators (used by MemoryManager only)
+        void recordAllocation(size_t sizeInWords, bool succeeded);
+        void recordFree();
+        void recordSplit();
+        void recordMerge();
+        void recordPurge(size_t bytes);
+        void recordUsed(size_t bytes);
+        void recordReleased(size_t bytes);
+        void recordAllocateLatency(uint64_t nanoseconds);
+        void recordFreeLatency(uint64_t nanoseconds);
+        void reset();                                 // clears the counters, bytesInUse is kept & becomes the peak
+        void clear();                                 // clears everything, bytesInUse too (the memory block is gone)
+
+        // Copies the counters into stats (hole figures are left as they are)
+        void snapshot(MemoryStats& stats) const;
+
+        // Accessors
+        uint64_t getAllocations() const;
+        uint64_t getFrees() const;
+        size_t getBytesInUse() const;
+        size_t getPeakBytesInUse() const;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "MemoryManager.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  ArenaAllocator Class Declaration                                              |
+|   - Standard library allocator handing out blocks of a MemoryManager, so       |
+|     std::vector, std::map, ... can live in its memory block                    |
+|     (e.g. std::vector<int, ArenaAllocator<int>> values(ArenaAllocator<int>(m)))|
+|   - Blocks are aligned to alignof(T) with allocateAligned                      |
+|   - Throws std::bad_alloc when the manager has no room, like std::allocator    |
+|   - Copies (& rebinds to other types) share the manager, which must outlive    |
+|     every container using it                                                   |
+|--------------------------------------------------------------------------------|
+*/
+template <typename T>
+class ArenaAllocator
+{
+ private:
+        MemoryManager* manager;
+
+ public:
+        using value_type = T;
+
+        explicit ArenaAllocator(MemoryManager& manager) noexcept : manager(&manager) {}
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : manager(other.getManager()) {}
+
+        T* allocate(size_t count)
+        {
+                if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+                {
+                        throw std::bad_array_new_length();
+                }
+                void* address = manager->allocateAligned(count * sizeof(T), alignof(T));
+                if (address == nullptr)
+                {
+                        throw std::bad_alloc();
+                }
+                return static_cast<T*>(address);
+        }
+
+        void deallocate(T* address, size_t) noexcept
+        {
+                manager->free(address);
+        }
+
+        MemoryManager* getManager() const noexcept
+        {
+                return manager;
+        }
+};
+
+// Allocators are interchangeable if they use the same manager (one frees what the other allocated)
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+{
+        return a.getManager() == b.getManager();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+{
+        return a.getManager() != b.getManager();
+}
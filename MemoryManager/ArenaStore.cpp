@@ -0,0 +1,209 @@
+#include "ArenaStore.h"
+
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*--------------------------------------------|
+|        ArenaStore Class Definitions         |
+|--------------------------------------------*/
+
+/* DESTRUCTOR:
+Returns the block to the heap / kernel
+*/
+ArenaStore::~ArenaStore()
+{
+    release();
+}
+
+/* ACQUIRE:
+Obtains a block of sizeInBytes from the given store, releasing any previous block first
+Returns false (and holds no block) if the store could not provide it
+*/
+bool ArenaStore::acquire(size_t sizeInBytes, BackingStore storeType)
+{
+    release();
+
+    if (sizeInBytes == 0)
+    {
+        return false;
+    }
+
+    void *block = nullptr;
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+    // File blocks need a file, see acquireFile
+    if (storeType == BackingStore::File)
+    {
+        return false;
+    }
+
+    if (storeType == BackingStore::Heap)
+    {
+        // aligned_alloc wants a multiple of the alignment; the memory is left untouched (no zero-fill)
+        reservedBytes = (sizeInBytes + heapAlignment - 1) / heapAlignment * heapAlignment;
+        block = std::aligned_alloc(heapAlignment, reservedBytes);
+    }
+    else
+    {
+        if (storeType == BackingStore::HugePages)
+        {
+            reservedBytes = (sizeInBytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+            block = mmap(nullptr, reservedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            hugeTlb = (block != MAP_FAILED);
+        }
+
+        if (!hugeTlb)
+        {
+            // MAP_NORESERVE: nothing is committed until a page is first touched
+            reservedBytes = (sizeInBytes + pageSize - 1) / pageSize * pageSize;
+            block = mmap(nullptr, reservedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+            if (block != MAP_FAILED && storeType == BackingStore::HugePages)
+            {
+                madvise(block, reservedBytes, MADV_HUGEPAGE);   // ask for transparent huge pages instead
+            }
+        }
+
+        if (block == MAP_FAILED)
+        {
+            block = nullptr;
+        }
+    }
+
+    if (block == nullptr)
+    {
+        reservedBytes = 0;
+        hugeTlb = false;
+        return false;
+    }
+
+    base = static_cast<uint8_t *>(block);
+    bytes = sizeInBytes;
+    type = storeType;
+    return true;
+}
+
+/* ACQUIRE FILE:
+Maps sizeInBytes of fd starting at offsetInBytes (a multiple of the page size) shared, releasing any previous block first
+The mapping goes at preferredAddress if that range is free (so addresses stay the same across runs), anywhere otherwise
+Returns false (and holds no block) if the file could not be mapped
+*/
+bool ArenaStore::acquireFile(int fd, size_t offsetInBytes, size_t sizeInBytes, void *preferredAddress)
+{
+    release();
+
+    if (sizeInBytes == 0)
+    {
+        return false;
+    }
+
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t mappedBytes = (sizeInBytes + pageSize - 1) / pageSize * pageSize;
+    void *block = mmap(preferredAddress, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offsetInBytes);
+    if (block == MAP_FAILED)
+    {
+        return false;
+    }
+
+    base = static_cast<uint8_t *>(block);
+    bytes = sizeInBytes;
+    reservedBytes = mappedBytes;
+    type = BackingStore::File;
+    return true;
+}
+
+/* FLUSH:
+Writes the dirty pages of a File block back with msync & waits until they are on disk; returns false if msync failed
+*/
+bool ArenaStore::flush()
+{
+    if (base == nullptr || type != BackingStore::File)
+    {
+        return true;
+    }
+    return msync(base, reservedBytes, MS_SYNC) == 0;
+}
+
+/* RELEASE:
+Gives the block back, if any
+*/
+void ArenaStore::release()
+{
+    if (base == nullptr)
+    {
+        return;
+    }
+
+    if (type == BackingStore::Heap)
+    {
+        std::free(base);
+    }
+    else
+    {
+        munmap(base, reservedBytes);
+    }
+
+    base = nullptr;
+    bytes = 0;
+    reservedBytes = 0;
+    hugeTlb = false;
+}
+
+/* RELEASE PAGES:
+Hands the pages of [offsetInBytes, offsetInBytes + lengthInBytes) back to the kernel, their contents are lost
+MADV_FREE (lazy) only drops them once the kernel needs the memory, and falls back to MADV_DONTNEED where it is not supported
+Returns false if the block can't release pages or madvise failed
+*/
+bool ArenaStore::releasePages(size_t offsetInBytes, size_t lengthInBytes, bool lazy)
+{
+    if (pageSize() == 0 || lengthInBytes == 0 || offsetInBytes + lengthInBytes > reservedBytes)
+    {
+        return false;
+    }
+
+#ifdef MADV_FREE
+    if (lazy && madvise(base + offsetInBytes, lengthInBytes, MADV_FREE) == 0)
+    {
+        return true;
+    }
+#endif
+    return madvise(base + offsetInBytes, lengthInBytes, MADV_DONTNEED) == 0;
+}
+
+uint8_t *ArenaStore::data() const
+{
+    return base;
+}
+
+// Number of bytes requested from acquire
+size_t ArenaStore::size() const
+{
+    return bytes;
+}
+
+// Number of bytes actually held (bytes rounded up to the heap alignment or page size)
+size_t ArenaStore::reservedSize() const
+{
+    return reservedBytes;
+}
+
+BackingStore ArenaStore::getType() const
+{
+    return type;
+}
+
+bool ArenaStore::usesHugeTlb() const
+{
+    return hugeTlb;
+}
+
+// MAP_HUGETLB pages are released whole, heap blocks belong to the C library & are never released
+size_t ArenaStore::pageSize() const
+{
+    if (base == nullptr || type == BackingStore::Heap)
+    {
+        return 0;
+    }
+    return hugeTlb ? hugePageSize : (size_t)sysconf(_SC_PAGESIZE);
+}
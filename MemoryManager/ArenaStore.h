@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Backing Store Types                                                           |
+|     - Heap: cache-line aligned heap block, not zero-filled                     |
+|     - Mmap: anonymous private mapping, pages are committed on first touch      |
+|     - HugePages: Mmap using MAP_HUGETLB, falls back to transparent huge pages  |
+|       (madvise MADV_HUGEPAGE) when no huge pages are reserved                  |
+|     - File: shared mapping of part of a file (acquireFile only, see            |
+|       MemoryManager::attach), stores reach the file & outlive the process      |
+|--------------------------------------------------------------------------------|
+*/
+enum class BackingStore { Heap, Mmap, HugePages, File };
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  ArenaStore Class Declaration                                                  |
+|   - Owns the raw bytes behind a MemoryManager's memory block                   |
+|   - Sized exactly to the bytes requested (rounded up to alignment/page size)   |
+|   - Mmap / HugePages / File blocks can hand pages back to the kernel           |
+|     (releasePages), the next touch of a released page faults in a zero-filled  |
+|     one (File blocks read it back from the file)                               |
+|--------------------------------------------------------------------------------|
+*/
+class ArenaStore
+{
+ private:
+        uint8_t* base = nullptr;                      // first byte of the block, nullptr if none acquired
+        size_t bytes = 0;                             // number of bytes requested
+        size_t reservedBytes = 0;                     // number of bytes actually obtained
+        BackingStore type = BackingStore::Heap;       // store the block came from
+        bool hugeTlb = false;                         // block is backed by MAP_HUGETLB pages
+
+ public:
+
+        static const size_t heapAlignment = 64;       // alignment of Heap blocks (one cache line)
+        static const size_t hugePageSize = 2 << 20;   // size MAP_HUGETLB mappings are rounded to
+
+        // Constructor / Destructor
+        ArenaStore() = default;
+        ~ArenaStore();
+        ArenaStore(const ArenaStore&) = delete;
+        ArenaStore& operator=(const ArenaStore&) = delete;
+
+        // Acquire / Release The Block
+        bool acquire(size_t sizeInBytes, BackingStore storeType);
+        bool acquireFile(int fd, size_t offsetInBytes, size_t sizeInBytes, void* preferredAddress);
+        void release();
+
+        // Writes dirty pages of a File block back to the file & waits for them (true for other stores)
+        bool flush();
+
+        // Page Release (offset & length are multiples of pageSize(), lazy uses MADV_FREE instead of MADV_DONTNEED)
+        bool releasePages(size_t offsetInBytes, size_t lengthInBytes, bool lazy);
+
+        // Get Functions (Accessors)
+        uint8_t* data() const;
+        size_t size() const;
+        size_t reservedSize() const;
+        BackingStore getType() const;
+        bool usesHugeTlb() const;
+        size_t pageSize() const;                      // granule of releasePages, 0 if the block can't release pages (Heap)
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MemoryManager.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  Fit Policy Declarations                                                       |
+|   - Compile-time counterparts of the built-in fit strategies                   |
+|   - A policy is any type with a static findHole(sizeInWords, holes) returning  |
+|     the word offset to allocate at, or -1 if nothing fits                      |
+|--------------------------------------------------------------------------------|
+*/
+struct BestFitPolicy
+{
+        static int64_t findHole(size_t sizeInWords, const HoleIndex& holes) { return holes.findBestFit(sizeInWords); }
+};
+
+struct WorstFitPolicy
+{
+        static int64_t findHole(size_t sizeInWords, const HoleIndex& holes) { return holes.findWorstFit(sizeInWords); }
+};
+
+struct FirstFitPolicy
+{
+        static int64_t findHole(size_t sizeInWords, const HoleIndex& holes) { return bitmapFirstFit(sizeInWords, holes); }
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  BasicMemoryManager Class Declaration                                          |
+|   - MemoryManager with the fit policy & word size fixed at compile time        |
+|   - allocate rounds with a shift/mask & calls FitPolicy::findHole directly,    |
+|     so the search can be inlined instead of going through a std::function     |
+|   - Its blocks are counted, timed, sampled & (hardened) guarded by the same    |
+|     code as MemoryManager::allocate                                            |
+|   - Everything else (free, getList, getBitmap, ...) is the MemoryManager one,  |
+|     and it can be passed wherever a MemoryManager& is expected                 |
+|--------------------------------------------------------------------------------|
+*/
+template <class FitPolicy, unsigned WordSize>
+class BasicMemoryManager : public MemoryManager
+{
+        static_assert(WordSize != 0 && (WordSize & (WordSize - 1)) == 0, "WordSize must be a power of two");
+
+ public:
+        static constexpr unsigned wordShift = __builtin_ctz(WordSize);
+        static constexpr size_t wordMask = WordSize - 1;
+
+ private:
+        const bool guarded = MemoryManager::isHardened();    // blocks need room for the hardened canary
+
+ public:
+        // Constructor (calls through a MemoryManager& use the same policy via the FitStrategy slot, unless setAllocator replaces it)
+        BasicMemoryManager() : MemoryManager(WordSize, FitStrategy(&FitPolicy::findHole)) {}
+
+        // Initialize (the policy searches the hole list, so other engines are not offered)
+        void initialize(size_t sizeInWords) { MemoryManager::initialize(sizeInWords); }
+
+        // Words needed for sizeInBytes (rounding up, the canary aside)
+        static constexpr size_t wordsFor(size_t sizeInBytes) { return (sizeInBytes + wordMask) >> wordShift; }
+
+        /* ALLOCATOR:
+        Same as MemoryManager::allocate, with the policy called directly; If no memory available or invalid size, returns nullptr
+        Never inlined, so the stack of a sampled block starts at the code calling allocate (the policy is still inlined here)
+        */
+        __attribute__((noinline)) void* allocate(size_t sizeInBytes)
+        {
+                size_t sizeInWords = guarded ? MemoryManager::wordsFor(sizeInBytes) : wordsFor(sizeInBytes);
+                if (sizeInWords == 0)
+                {
+                        return nullptr;
+                }
+                if (getRegionDepth() != 0)
+                {
+                        return allocateFrom(sizeInBytes, __builtin_return_address(0));    // regions bump blocks out of their reserved block instead
+                }
+
+                uint64_t began = startTiming();
+                listNode* node = claimHole(FitPolicy::findHole(sizeInWords, getHoleIndex()), sizeInWords);
+                void* address = node == nullptr ? nullptr : static_cast<uint8_t*>(getMemoryStart()) + (node->headIndex << wordShift);
+                return finishAllocate(address, sizeInWords, sizeInBytes, began, __builtin_return_address(0));
+        }
+};
@@ -0,0 +1,672 @@
+#include "MemoryManager.h"
+#include "BasicMemoryManager.h"
+#include "ConcurrentMemoryManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+/*
+|--------------------------------------------------------------------------------|
+|  MemoryManager Benchmark                                                       |
+|     - Runs each workload on each strategy at each arena size, reporting        |
+|       throughput, latency percentiles (one timed allocate / free each),        |
+|       failed allocations & external fragmentation at the end                   |
+|     - Workloads: churn (one size), mixed (random sizes), prodcons (blocks      |
+|       freed by another thread), aging (full arena, random frees/allocations)   |
+|     - --trace replays a recorded allocate/free trace instead, one op per line: |
+|           a <id> <bytes>      allocate, naming the block id                    |
+|           f <id>              free the block named id                          |
+|       (blank lines & lines starting with # are skipped)                        |
+|                                                                                |
+|  Usage: benchmark [--words 1K,64K,1M] [--ops N] [--seed N]                     |
+|                   [--strategies name,...] [--workloads name,...]               |
+|                   [--trace file]                                               |
+|     - Arena sizes default to 1K, 64K & 1M words; add 64M to --words for the    |
+|       largest arenas (the list & bitmap strategies take minutes there)         |
+|--------------------------------------------------------------------------------|
+*/
+
+static const unsigned wordSize = 8;
+
+/*--------------------------------------------|
+|        Benchmark Targets                    |
+|--------------------------------------------*/
+
+// What a workload allocates from
+class BenchTarget
+{
+ public:
+        virtual ~BenchTarget() = default;
+        virtual void* allocate(size_t sizeInBytes) = 0;
+        virtual void free(void* address) = 0;
+        virtual bool isThreadSafe() { return false; }
+        virtual double fragmentation() { return -1; }      // -1 if the target does not report it
+};
+
+// A MemoryManager used directly
+class ManagerTarget : public BenchTarget
+{
+ private:
+        std::unique_ptr<MemoryManager> manager;
+
+ public:
+        ManagerTarget(MemoryManager* manager, size_t sizeInWords, EngineType engineType) : manager(manager)
+        {
+            this->manager->initialize(sizeInWords, engineType);
+        }
+        void* allocate(size_t sizeInBytes) override { return manager->allocate(sizeInBytes); }
+        void free(void* address) override { manager->free(address); }
+        double fragmentation() override { return manager->getStats().fragmentation; }
+};
+
+// BasicMemoryManager hides initialize(size, engine)
+template <class FitPolicy>
+class BasicTarget : public BenchTarget
+{
+ private:
+        BasicMemoryManager<FitPolicy, wordSize> manager;
+
+ public:
+        BasicTarget(size_t sizeInWords) { manager.initialize(sizeInWords); }
+        void* allocate(size_t sizeInBytes) override { return manager.allocate(sizeInBytes); }
+        void free(void* address) override { manager.free(address); }
+        double fragmentation() override { return manager.getStats().fragmentation; }
+};
+
+class ConcurrentTarget : public BenchTarget
+{
+ private:
+        ConcurrentMemoryManager manager;
+
+ public:
+        ConcurrentTarget(size_t sizeInWords) : manager(wordSize, FitStrategy(indexedBestFit)) { manager.initialize(sizeInWords); }
+        void* allocate(size_t sizeInBytes) override { return manager.allocate(sizeInBytes); }
+        void free(void* address) override { manager.free(address); }
+        bool isThreadSafe() override { return true; }
+};
+
+// Serialises calls to a target that is not thread-safe (for prodcons)
+class LockedTarget : public BenchTarget
+{
+ private:
+        BenchTarget& target;
+        std::mutex lock;
+
+ public:
+        LockedTarget(BenchTarget& target) : target(target) {}
+        void* allocate(size_t sizeInBytes) override { std::lock_guard<std::mutex> guard(lock); return target.allocate(sizeInBytes); }
+        void free(void* address) override { std::lock_guard<std::mutex> guard(lock); target.free(address); }
+        bool isThreadSafe() override { return true; }
+};
+
+struct Strategy
+{
+        std::string name;
+        std::function<BenchTarget*(size_t sizeInWords)> make;
+};
+
+// Helper function: a MemoryManager target using the list allocator, taking the Wide64 version above 65536 words (the uint16_t list would truncate)
+static BenchTarget* listTarget(size_t sizeInWords, std::function<int(int, void*)> narrow, WideAllocator wide)
+{
+    MemoryManager* manager = sizeInWords > 65536 ? new MemoryManager(wordSize, wide) : new MemoryManager(wordSize, narrow);
+    return new ManagerTarget(manager, sizeInWords, EngineType::HoleList);
+}
+
+static BenchTarget* fitTarget(size_t sizeInWords, FitStrategy strategy, EngineType engineType = EngineType::HoleList)
+{
+    return new ManagerTarget(new MemoryManager(wordSize, strategy), sizeInWords, engineType);
+}
+
+static std::vector<Strategy> allStrategies()
+{
+    return {
+        {"bestFit", [](size_t words) { return listTarget(words, bestFit, bestFitWide); }},
+        {"worstFit", [](size_t words) { return listTarget(words, worstFit, worstFitWide); }},
+        {"indexedBestFit", [](size_t words) { return fitTarget(words, indexedBestFit); }},
+        {"indexedWorstFit", [](size_t words) { return fitTarget(words, indexedWorstFit); }},
+        {"bitmapFirstFit", [](size_t words) { return fitTarget(words, bitmapFirstFit); }},
+        {"bitmapNextFit", [](size_t words) { return fitTarget(words, BitmapNextFit()); }},
+        {"basicBestFit", [](size_t words) -> BenchTarget * { return new BasicTarget<BestFitPolicy>(words); }},
+        {"buddy", [](size_t words) { return fitTarget(words, indexedBestFit, EngineType::Buddy); }},
+        {"tlsf", [](size_t words) { return fitTarget(words, indexedBestFit, EngineType::Tlsf); }},
+        {"concurrent", [](size_t words) -> BenchTarget * { return new ConcurrentTarget(words); }},
+    };
+}
+
+
+/*--------------------------------------------|
+|        Measurement                          |
+|--------------------------------------------*/
+
+struct Result
+{
+        std::vector<uint64_t> latencies;              // nanoseconds of each timed call
+        double seconds = 0;                           // wall time of the timed part
+        size_t failures = 0;                          // allocations that returned nullptr
+        double fragmentation = -1;
+};
+
+// Times each call of one thread into its own result
+class Recorder
+{
+ private:
+        BenchTarget& target;
+        Result& result;
+
+ public:
+        Recorder(BenchTarget& target, Result& result) : target(target), result(result) {}
+
+        void* allocate(size_t sizeInBytes)
+        {
+            auto began = std::chrono::steady_clock::now();
+            void* address = target.allocate(sizeInBytes);
+            result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - began).count());
+            result.failures += address == nullptr;
+            return address;
+        }
+
+        void free(void* address)
+        {
+            auto began = std::chrono::steady_clock::now();
+            target.free(address);
+            result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - began).count());
+        }
+};
+
+// Helper function: seconds since began
+static double secondsSince(std::chrono::steady_clock::time_point began)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+}
+
+// Helper function: random size of between 1 & maxWords words, log-uniform (small blocks are common, large ones rare)
+static size_t randomBytes(std::mt19937_64& rng, size_t maxWords)
+{
+    double exponent = std::uniform_real_distribution<double>(0, std::log2((double)maxWords + 1))(rng);
+    size_t words = std::max<size_t>(1, (size_t)std::exp2(exponent));
+    return std::min(words, maxWords) * wordSize;
+}
+
+// Helper function: number of block slots a workload keeps, so about a quarter of the arena is live (bounded by the op count)
+static size_t slotCount(size_t sizeInWords, size_t averageWords, size_t ops)
+{
+    return std::max<size_t>(1, std::min(sizeInWords / (2 * averageWords), std::max<size_t>(1, ops / 4)));
+}
+
+
+/*--------------------------------------------|
+|        Workloads                            |
+|--------------------------------------------*/
+
+// Single-size churn: each op allocates or frees a 4 word block in a random slot
+static Result runChurn(BenchTarget& target, size_t sizeInWords, size_t ops, std::mt19937_64& rng)
+{
+    Result result;
+    Recorder recorder(target, result);
+    std::vector<void*> slots(slotCount(sizeInWords, 4, ops), nullptr);
+    result.latencies.reserve(ops);
+
+    auto began = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; i++)
+    {
+        void*& slot = slots[rng() % slots.size()];
+        if (slot)
+        {
+            recorder.free(slot);
+            slot = nullptr;
+        }
+        else
+        {
+            slot = recorder.allocate(4 * wordSize);
+        }
+    }
+    result.seconds = secondsSince(began);
+    result.fragmentation = target.fragmentation();
+
+    for (void* slot : slots)
+    {
+        target.free(slot);
+    }
+    return result;
+}
+
+// Mixed-size random: like churn with sizes of 1 to 256 words
+static Result runMixed(BenchTarget& target, size_t sizeInWords, size_t ops, std::mt19937_64& rng)
+{
+    Result result;
+    Recorder recorder(target, result);
+    size_t maxWords = std::min<size_t>(256, std::max<size_t>(1, sizeInWords / 16));
+    std::vector<void*> slots(slotCount(sizeInWords, maxWords / 5 + 1, ops), nullptr);
+    result.latencies.reserve(ops);
+
+    auto began = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; i++)
+    {
+        void*& slot = slots[rng() % slots.size()];
+        if (slot)
+        {
+            recorder.free(slot);
+            slot = nullptr;
+        }
+        else
+        {
+            slot = recorder.allocate(randomBytes(rng, maxWords));
+        }
+    }
+    result.seconds = secondsSince(began);
+    result.fragmentation = target.fragmentation();
+
+    for (void* slot : slots)
+    {
+        target.free(slot);
+    }
+    return result;
+}
+
+// Producer/consumer: one thread allocates 1 to 64 word blocks & hands them over a ring to another thread, which frees them
+static Result runProducerConsumer(BenchTarget& target, size_t sizeInWords, size_t ops, std::mt19937_64& rng)
+{
+    std::unique_ptr<LockedTarget> locked(target.isThreadSafe() ? nullptr : new LockedTarget(target));
+    BenchTarget& shared = locked ? *locked : target;
+
+    size_t maxWords = std::min<size_t>(64, std::max<size_t>(1, sizeInWords / 16));
+    const size_t ringSize = std::min<size_t>(1024, slotCount(sizeInWords, maxWords / 4 + 1, ops));    // blocks in flight stay within about a quarter of the arena
+    std::vector<std::atomic<void*>> ring(ringSize);
+    std::atomic<size_t> produced{0};
+    std::atomic<size_t> consumed{0};
+    std::atomic<bool> done{false};
+
+    Result result;
+    Result consumerResult;
+    result.latencies.reserve(ops);
+    consumerResult.latencies.reserve(ops / 2);
+
+    auto began = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        Recorder recorder(shared, consumerResult);
+        while (true)
+        {
+            size_t slot = consumed.load(std::memory_order_relaxed);
+            if (slot == produced.load(std::memory_order_acquire))
+            {
+                if (done.load(std::memory_order_acquire) && slot == produced.load(std::memory_order_acquire))
+                {
+                    return;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            recorder.free(ring[slot % ringSize].load(std::memory_order_relaxed));
+            consumed.store(slot + 1, std::memory_order_release);
+        }
+    });
+
+    Recorder recorder(shared, result);
+    for (size_t i = 0; i < ops / 2; i++)
+    {
+        void* address = recorder.allocate(randomBytes(rng, maxWords));
+        if (address == nullptr)
+        {
+            continue;
+        }
+
+        // Wait for room in the ring
+        size_t slot = produced.load(std::memory_order_relaxed);
+        while (slot - consumed.load(std::memory_order_acquire) >= ringSize)
+        {
+            std::this_thread::yield();
+        }
+        ring[slot % ringSize].store(address, std::memory_order_relaxed);
+        produced.store(slot + 1, std::memory_order_release);
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    result.seconds = secondsSince(began);
+    result.latencies.insert(result.latencies.end(), consumerResult.latencies.begin(), consumerResult.latencies.end());
+    result.fragmentation = target.fragmentation();
+    return result;
+}
+
+// Fragmentation aging: fills the arena to about 85% with blocks of 1 to 64 words (untimed), then each op frees a random block & allocates up to twice that
+// Above 4M words fill blocks grow with the arena (up to sizeInWords / 65536 words), so large arenas fill in a bounded number of blocks
+static Result runAging(BenchTarget& target, size_t sizeInWords, size_t ops, std::mt19937_64& rng)
+{
+    Result result;
+    Recorder recorder(target, result);
+    size_t fillWords = std::min<size_t>(std::max<size_t>(64, sizeInWords >> 16), std::max<size_t>(1, sizeInWords / 16));
+    size_t maxWords = std::min<size_t>(2 * fillWords, std::max<size_t>(1, sizeInWords / 8));
+
+    std::vector<void*> live;
+    size_t liveWords = 0;
+    while (liveWords < sizeInWords / 20 * 17)
+    {
+        size_t sizeInBytes = randomBytes(rng, fillWords);
+        void* address = target.allocate(sizeInBytes);
+        if (address == nullptr)
+        {
+            break;
+        }
+        live.push_back(address);
+        liveWords += sizeInBytes / wordSize;
+    }
+    result.latencies.reserve(2 * ops);
+
+    auto began = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops && !live.empty(); i++)
+    {
+        size_t victim = rng() % live.size();
+        recorder.free(live[victim]);
+
+        void* address = recorder.allocate(randomBytes(rng, maxWords));
+        if (address)
+        {
+            live[victim] = address;
+        }
+        else
+        {
+            live[victim] = live.back();
+            live.pop_back();
+        }
+    }
+    result.seconds = secondsSince(began);
+    result.fragmentation = target.fragmentation();
+
+    for (void* address : live)
+    {
+        target.free(address);
+    }
+    return result;
+}
+
+struct TraceOp
+{
+        bool isAllocate;
+        uint64_t id;
+        size_t sizeInBytes;
+};
+
+// Helper function: reads a trace file (see the top of this file), returns false if it cannot be opened or has a malformed line
+static bool readTrace(const std::string& filename, std::vector<TraceOp>& trace)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string op;
+        TraceOp traced{false, 0, 0};
+        fields >> op >> traced.id;
+        traced.isAllocate = op == "a";
+        if (!fields || (op != "a" && op != "f") || (traced.isAllocate && !(fields >> traced.sizeInBytes)))
+        {
+            std::cerr << "malformed trace line: " << line << std::endl;
+            return false;
+        }
+        trace.push_back(traced);
+    }
+    return true;
+}
+
+// Trace replay: allocates & frees as recorded (frees of ids that failed or were never allocated are skipped), blocks still live at the end are freed untimed
+static Result runTrace(BenchTarget& target, const std::vector<TraceOp>& trace)
+{
+    Result result;
+    Recorder recorder(target, result);
+    std::unordered_map<uint64_t, void*> blocks;
+    result.latencies.reserve(trace.size());
+
+    auto began = std::chrono::steady_clock::now();
+    for (const TraceOp& traced : trace)
+    {
+        if (traced.isAllocate)
+        {
+            void* address = recorder.allocate(traced.sizeInBytes);
+            if (address)
+            {
+                blocks[traced.id] = address;
+            }
+            continue;
+        }
+
+        auto found = blocks.find(traced.id);
+        if (found != blocks.end())
+        {
+            recorder.free(found->second);
+            blocks.erase(found);
+        }
+    }
+    result.seconds = secondsSince(began);
+    result.fragmentation = target.fragmentation();
+
+    for (auto& block : blocks)
+    {
+        target.free(block.second);
+    }
+    return result;
+}
+
+
+/*--------------------------------------------|
+|        Reporting & Options                  |
+|--------------------------------------------*/
+
+// Helper function: latency at quantile of sorted latencies
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double quantile)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    return sorted[std::min(sorted.size() - 1, (size_t)(quantile * sorted.size()))];
+}
+
+static void printHeader()
+{
+    printf("%-9s %10s %-16s %10s %9s %8s %8s %8s %8s %10s %9s %6s\n", "workload", "words", "strategy", "calls", "Mcalls/s",
+           "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "failures", "frag");
+}
+
+static void printResult(const std::string& workload, size_t sizeInWords, const std::string& strategy, Result& result)
+{
+    std::sort(result.latencies.begin(), result.latencies.end());
+    double rate = result.seconds > 0 ? result.latencies.size() / result.seconds / 1e6 : 0;
+    char fragmentation[16] = "-";
+    if (result.fragmentation >= 0)
+    {
+        snprintf(fragmentation, sizeof(fragmentation), "%.3f", result.fragmentation);
+    }
+
+    printf("%-9s %10zu %-16s %10zu %9.2f %8lu %8lu %8lu %8lu %10lu %9zu %6s\n", workload.c_str(), sizeInWords, strategy.c_str(),
+           result.latencies.size(), rate, (unsigned long)percentile(result.latencies, 0.5), (unsigned long)percentile(result.latencies, 0.9),
+           (unsigned long)percentile(result.latencies, 0.99), (unsigned long)percentile(result.latencies, 0.999),
+           (unsigned long)(result.latencies.empty() ? 0 : result.latencies.back()), result.failures, fragmentation);
+    fflush(stdout);
+}
+
+// Helper function: splits "a,b,c" into its names
+static std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> names;
+    std::istringstream fields(list);
+    std::string name;
+    while (std::getline(fields, name, ','))
+    {
+        if (!name.empty())
+        {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+// Helper function: parses a count with an optional K or M suffix (1K = 1024), 0 if malformed
+static size_t parseCount(const std::string& text)
+{
+    char* end = nullptr;
+    size_t count = strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str())
+    {
+        return 0;
+    }
+    if (*end == 'K' || *end == 'k')
+    {
+        count <<= 10;
+        end++;
+    }
+    else if (*end == 'M' || *end == 'm')
+    {
+        count <<= 20;
+        end++;
+    }
+    return *end == '\0' ? count : 0;
+}
+
+static int usage()
+{
+    std::cerr << "usage: benchmark [--words 1K,64K,1M] [--ops N] [--seed N] [--strategies name,...] [--workloads name,...] [--trace file]\n"
+              << "workloads: churn mixed prodcons aging\nstrategies:";
+    for (const Strategy& strategy : allStrategies())
+    {
+        std::cerr << " " << strategy.name;
+    }
+    std::cerr << std::endl;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<size_t> arenaSizes = {1 << 10, 1 << 16, 1 << 20};
+    std::vector<std::string> workloads = {"churn", "mixed", "prodcons", "aging"};
+    std::vector<Strategy> strategies = allStrategies();
+    size_t ops = 100000;
+    uint64_t seed = 1;
+    std::string traceFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            return usage();
+        }
+        std::string value = argv[++i];
+
+        if (option == "--words")
+        {
+            arenaSizes.clear();
+            for (const std::string& size : splitList(value))
+            {
+                if (parseCount(size) == 0)
+                {
+                    return usage();
+                }
+                arenaSizes.push_back(parseCount(size));
+            }
+        }
+        else if (option == "--ops" && parseCount(value) != 0)
+        {
+            ops = parseCount(value);
+        }
+        else if (option == "--seed")
+        {
+            seed = strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (option == "--strategies")
+        {
+            std::vector<Strategy> chosen;
+            for (const std::string& name : splitList(value))
+            {
+                auto found = std::find_if(strategies.begin(), strategies.end(), [&name](const Strategy& strategy) { return strategy.name == name; });
+                if (found == strategies.end())
+                {
+                    return usage();
+                }
+                chosen.push_back(*found);
+            }
+            strategies = chosen;
+        }
+        else if (option == "--workloads")
+        {
+            workloads = splitList(value);
+        }
+        else if (option == "--trace")
+        {
+            traceFile = value;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    std::vector<TraceOp> trace;
+    if (!traceFile.empty())
+    {
+        if (!readTrace(traceFile, trace))
+        {
+            std::cerr << "cannot read trace " << traceFile << std::endl;
+            return 1;
+        }
+        workloads = {"trace"};
+    }
+
+    printHeader();
+    for (const std::string& workload : workloads)
+    {
+        for (size_t sizeInWords : arenaSizes)
+        {
+            for (const Strategy& strategy : strategies)
+            {
+                std::unique_ptr<BenchTarget> target(strategy.make(sizeInWords));
+                std::mt19937_64 rng(seed);
+                Result result;
+
+                if (workload == "churn")
+                {
+                    result = runChurn(*target, sizeInWords, ops, rng);
+                }
+                else if (workload == "mixed")
+                {
+                    result = runMixed(*target, sizeInWords, ops, rng);
+                }
+                else if (workload == "prodcons")
+                {
+                    result = runProducerConsumer(*target, sizeInWords, ops, rng);
+                }
+                else if (workload == "aging")
+                {
+                    result = runAging(*target, sizeInWords, ops, rng);
+                }
+                else if (workload == "trace")
+                {
+                    result = runTrace(*target, trace);
+                }
+                else
+                {
+                    return usage();
+                }
+                printResult(workload, sizeInWords, strategy.name, result);
+            }
+        }
+    }
+    return 0;
+}
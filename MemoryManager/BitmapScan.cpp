@@ -0,0 +1,219 @@
+#include "BitmapScan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITMAP_SCAN_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define BITMAP_SCAN_NEON 1
+#endif
+
+/*-------------------------------------------|
+|       Block Skipping Kernels               |
+|-------------------------------------------*/
+
+// Each returns the index of the first block in [from, count) that is not equal to pattern (all used or all free), count if none
+
+static size_t skipBlocksScalar(const uint64_t *bits, size_t from, size_t count, uint64_t pattern)
+{
+    while (from < count && bits[from] == pattern)
+    {
+        from++;
+    }
+    return from;
+}
+
+#if BITMAP_SCAN_X86
+__attribute__((target("avx2"))) static size_t skipBlocksAvx2(const uint64_t *bits, size_t from, size_t count, uint64_t pattern)
+{
+    const __m256i match = _mm256_set1_epi64x((long long)pattern);
+
+    // Compare 4 blocks (256 bits of memory words) at a time, stop at the first group with a mismatch
+    while (from + 4 <= count)
+    {
+        __m256i group = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bits + from));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(group, match)) != -1)
+        {
+            break;
+        }
+        from += 4;
+    }
+    return skipBlocksScalar(bits, from, count, pattern);
+}
+
+__attribute__((target("sse4.1"))) static size_t skipBlocksSse41(const uint64_t *bits, size_t from, size_t count, uint64_t pattern)
+{
+    const __m128i match = _mm_set1_epi64x((long long)pattern);
+
+    while (from + 2 <= count)
+    {
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bits + from));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi64(group, match)) != 0xFFFF)
+        {
+            break;
+        }
+        from += 2;
+    }
+    return skipBlocksScalar(bits, from, count, pattern);
+}
+#endif
+
+#if BITMAP_SCAN_NEON
+static size_t skipBlocksNeon(const uint64_t *bits, size_t from, size_t count, uint64_t pattern)
+{
+    const uint64x2_t match = vdupq_n_u64(pattern);
+
+    while (from + 2 <= count)
+    {
+        uint64x2_t equal = vceqq_u64(vld1q_u64(bits + from), match);
+        if ((vgetq_lane_u64(equal, 0) & vgetq_lane_u64(equal, 1)) != ~0ULL)
+        {
+            break;
+        }
+        from += 2;
+    }
+    return skipBlocksScalar(bits, from, count, pattern);
+}
+#endif
+
+typedef size_t (*SkipKernel)(const uint64_t *, size_t, size_t, uint64_t);
+
+// Picks the widest kernel this CPU supports
+static SkipKernel selectKernel(const char **name)
+{
+#if BITMAP_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        *name = "avx2";
+        return skipBlocksAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        *name = "sse4.1";
+        return skipBlocksSse41;
+    }
+#elif BITMAP_SCAN_NEON
+    *name = "neon";
+    return skipBlocksNeon;
+#endif
+    *name = "scalar";
+    return skipBlocksScalar;
+}
+
+static const char *kernelName = "scalar";
+
+// Kernel chosen on first use (safe to call from other static initializers)
+static size_t skipBlocks(const uint64_t *bits, size_t from, size_t count, uint64_t pattern)
+{
+    static const SkipKernel kernel = selectKernel(&kernelName);
+    return kernel(bits, from, count, pattern);
+}
+
+
+/*-------------------------------------------|
+|          Free Run Search                   |
+|-------------------------------------------*/
+
+// Returns block i of the bitmap, with words past sizeInWords (and before fromWord) reading as used
+static inline uint64_t loadBlock(const uint64_t *bits, size_t i, size_t sizeInWords, size_t fromWord)
+{
+    uint64_t block = bits[i];
+    if ((i + 1) * 64 > sizeInWords)
+    {
+        block |= ~0ULL << (sizeInWords % 64);
+    }
+    if (i == fromWord / 64)
+    {
+        block |= ~(~0ULL << (fromWord % 64));
+    }
+    return block;
+}
+
+// Bit j of the result is set iff free bits j .. j + runLength - 1 are all set (runLength <= 64)
+static inline uint64_t runStarts(uint64_t free, size_t runLength)
+{
+    size_t covered = 1;
+    while (covered < runLength)
+    {
+        size_t step = covered < runLength - covered ? covered : runLength - covered;
+        free &= free >> step;
+        covered += step;
+    }
+    return free;
+}
+
+int64_t findFreeRun(const uint64_t *bits, size_t sizeInWords, size_t runLength, size_t fromWord)
+{
+    if (runLength == 0 || fromWord >= sizeInWords || runLength > sizeInWords - fromWord)
+    {
+        return -1;
+    }
+
+    size_t count = (sizeInWords + 63) / 64;
+    size_t run = 0;                 // length of the free run ending at the current block boundary
+    size_t runStart = 0;            // word offset where that run starts
+
+    for (size_t i = fromWord / 64; i < count; i++)
+    {
+        // With no run pending, jump straight over fully used blocks
+        if (run == 0 && i * 64 + 64 <= sizeInWords && i != fromWord / 64 && bits[i] == ~0ULL)
+        {
+            i = skipBlocks(bits, i, count, ~0ULL);
+            if (i == count)
+            {
+                return -1;
+            }
+        }
+
+        uint64_t used = loadBlock(bits, i, sizeInWords, fromWord);
+
+        if (used == 0)
+        {
+            if (run == 0)
+            {
+                runStart = i * 64;
+            }
+
+            // A long request swallows whole free blocks at once
+            size_t freeEnd = (run + 64 < runLength) ? skipBlocks(bits, i + 1, count - 1, 0) : i + 1;
+            run += (freeEnd - i) * 64;
+            i = freeEnd - 1;
+
+            if (run >= runLength)
+            {
+                return runStart;
+            }
+            continue;
+        }
+
+        // The run from earlier blocks continues through the trailing zeros of this one
+        size_t lowFree = __builtin_ctzll(used);
+        if (run > 0 && run + lowFree >= runLength)
+        {
+            return runStart;
+        }
+
+        // A run lying entirely inside this block
+        if (runLength <= 64 && (size_t)__builtin_popcountll(~used) >= runLength)
+        {
+            uint64_t starts = runStarts(~used, runLength);
+            if (starts != 0)
+            {
+                return i * 64 + __builtin_ctzll(starts);
+            }
+        }
+
+        // A run starting in the leading zeros at the top of this block
+        size_t highFree = __builtin_clzll(used);
+        run = highFree;
+        runStart = i * 64 + 64 - highFree;
+    }
+    return -1;
+}
+
+const char *bitmapScanKernel()
+{
+    skipBlocks(nullptr, 0, 0, 0);       // makes sure the kernel has been selected
+    return kernelName;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Bitmap Scan Kernels                                                           |
+|   - Search a packed occupancy bitmap (bit set = word used) for runs of free    |
+|     words, with ctz/clz/popcount inside each uint64_t                          |
+|   - Fully used / fully free stretches are skipped with vector compares (AVX2   |
+|     256-bit lanes, SSE4.1 128-bit lanes or NEON), picked at run time, with a   |
+|     scalar fallback everywhere else                                            |
+|--------------------------------------------------------------------------------|
+*/
+
+// Returns word offset of the first run of runLength free words starting at or after fromWord, -1 if there is none
+int64_t findFreeRun(const uint64_t* bits, size_t sizeInWords, size_t runLength, size_t fromWord = 0);
+
+// Name of the kernel findFreeRun dispatches to on this machine ("avx2", "sse4.1", "neon" or "scalar")
+const char* bitmapScanKernel();
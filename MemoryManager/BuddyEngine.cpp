@@ -0,0 +1,228 @@
+#include <algorithm>
+
+#include "BuddyEngine.h"
+
+/*--------------------------------------------|
+|        BuddyEngine Class Definitions        |
+|--------------------------------------------*/
+
+/* CONTSTRUCTOR:
+Tiles the words with the largest aligned power-of-two free blocks that fit
+*/
+BuddyEngine::BuddyEngine(size_t sizeInWords) : sizeInWords(sizeInWords)
+{
+    orderCount = sizeInWords == 0 ? 0 : 64 - __builtin_clzll(sizeInWords);
+    freeBits.resize(orderCount);
+    freeLists.resize(orderCount);
+    orderOf.assign(sizeInWords, 0);
+
+    for (unsigned order = 0; order < orderCount; order++)
+    {
+        freeBits[order].assign((sizeInWords >> order) / 64 + 1, 0);
+    }
+
+    size_t offset = 0;
+    while (offset < sizeInWords)
+    {
+        // Largest order the offset is aligned to that still fits before the end
+        unsigned order = offset == 0 ? orderCount - 1 : std::min<unsigned>(__builtin_ctzll(offset), orderCount - 1);
+        while (offset + ((size_t)1 << order) > sizeInWords)
+        {
+            order--;
+        }
+        addFree(order, offset);
+        offset += (size_t)1 << order;
+    }
+}
+
+/* ALLOCATOR:
+Takes the lowest free block of the smallest order that fits, halving it down to the order requested
+Returns -1 if no free block is large enough
+*/
+int64_t BuddyEngine::allocate(size_t sizeInWords)
+{
+    if (sizeInWords == 0 || sizeInWords > this->sizeInWords)
+    {
+        return -1;
+    }
+
+    unsigned order = sizeInWords <= 1 ? 0 : 64 - __builtin_clzll(sizeInWords - 1);
+    if (order >= orderCount)
+    {
+        return -1;
+    }
+
+    uint64_t candidates = nonEmptyOrders & (~(uint64_t)0 << order);
+    if (candidates == 0)
+    {
+        return -1;
+    }
+
+    unsigned found = __builtin_ctzll(candidates);
+    size_t offset = *freeLists[found].begin();
+    removeFree(found, offset);
+
+    // The upper half of each split becomes a free block one order down
+    while (found > order)
+    {
+        found--;
+        addFree(found, offset + ((size_t)1 << found));
+    }
+
+    orderOf[offset] = (uint8_t)(order + 1);
+    return (int64_t)offset;
+}
+
+/* ALIGNED ALLOCATOR:
+Takes the lowest free block of the smallest order holding a block of the order requested at an offset % alignInWords == phase,
+halving it down to that block (the other halves become free blocks); returns -1 if there is none
+*/
+int64_t BuddyEngine::allocateAligned(size_t sizeInWords, size_t alignInWords, size_t phase)
+{
+    if (sizeInWords == 0 || sizeInWords > this->sizeInWords)
+    {
+        return -1;
+    }
+
+    unsigned order = sizeInWords <= 1 ? 0 : 64 - __builtin_clzll(sizeInWords - 1);
+    if (order >= orderCount || phase % ((size_t)1 << order) != 0)
+    {
+        return -1;                                            // blocks of this order always start at multiples of their size
+    }
+
+    for (unsigned found = order; found < orderCount; found++)
+    {
+        size_t blockWords = (size_t)1 << found;
+        if ((nonEmptyOrders >> found & 1) == 0)
+        {
+            continue;
+        }
+
+        // Blocks at least alignInWords long all hold a suitable offset, smaller ones only if it falls inside them
+        for (size_t offset : freeLists[found])
+        {
+            size_t target = offset + ((phase - offset) & (alignInWords - 1));
+            if (target - offset >= blockWords)
+            {
+                continue;
+            }
+
+            removeFree(found, offset);
+
+            // Keep the half holding target, the other half becomes a free block one order down
+            while (found > order)
+            {
+                found--;
+                size_t half = (size_t)1 << found;
+                if (target >= offset + half)
+                {
+                    addFree(found, offset);
+                    offset += half;
+                }
+                else
+                {
+                    addFree(found, offset + half);
+                }
+            }
+
+            orderOf[offset] = (uint8_t)(order + 1);
+            return (int64_t)offset;
+        }
+    }
+    return -1;
+}
+
+/* DEALLOCATOR:
+Frees the block at offset, merging it with its buddy for as long as the buddy is a free block of the same order
+*/
+size_t BuddyEngine::free(size_t offset)
+{
+    if (offset >= sizeInWords || orderOf[offset] == 0)
+    {
+        return 0;
+    }
+
+    unsigned order = orderOf[offset] - 1;
+    orderOf[offset] = 0;
+    size_t released = (size_t)1 << order;
+
+    while (order + 1 < orderCount)
+    {
+        size_t buddy = offset ^ ((size_t)1 << order);
+        if (!isFree(order, buddy))
+        {
+            break;
+        }
+        removeFree(order, buddy);
+        offset = std::min(offset, buddy);
+        order++;
+    }
+
+    addFree(order, offset);
+    return released;
+}
+
+/* GET BLOCK SIZE:
+Returns the size in words of the allocated block at offset (0 if there is none)
+*/
+size_t BuddyEngine::blockSize(size_t offset) const
+{
+    if (offset >= sizeInWords || orderOf[offset] == 0)
+    {
+        return 0;
+    }
+    return (size_t)1 << (orderOf[offset] - 1);
+}
+
+/* FOR EACH HOLE:
+Visits every free block in offset order (touching free blocks of different orders are visited separately)
+*/
+void BuddyEngine::forEachHole(const std::function<void(size_t offset, size_t size)> &visit) const
+{
+    std::vector<std::pair<size_t, size_t>> blocks;
+    for (unsigned order = 0; order < orderCount; order++)
+    {
+        for (size_t offset : freeLists[order])
+        {
+            blocks.push_back({offset, (size_t)1 << order});
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+
+    for (auto &block : blocks)
+    {
+        visit(block.first, block.second);
+    }
+}
+
+// Helper function: whether a free block of the given order starts at offset (false for buddies past the end)
+bool BuddyEngine::isFree(unsigned order, size_t offset) const
+{
+    if (offset + ((size_t)1 << order) > sizeInWords)
+    {
+        return false;
+    }
+    size_t bit = offset >> order;
+    return (freeBits[order][bit / 64] >> (bit % 64)) & 1;
+}
+
+// Helper function: records a free block in its order's bitmap & free list
+void BuddyEngine::addFree(unsigned order, size_t offset)
+{
+    size_t bit = offset >> order;
+    freeBits[order][bit / 64] |= (uint64_t)1 << (bit % 64);
+    freeLists[order].insert(offset);
+    nonEmptyOrders |= (uint64_t)1 << order;
+}
+
+// Helper function: drops a free block from its order's bitmap & free list
+void BuddyEngine::removeFree(unsigned order, size_t offset)
+{
+    size_t bit = offset >> order;
+    freeBits[order][bit / 64] &= ~((uint64_t)1 << (bit % 64));
+    freeLists[order].erase(offset);
+    if (freeLists[order].empty())
+    {
+        nonEmptyOrders &= ~((uint64_t)1 << order);
+    }
+}
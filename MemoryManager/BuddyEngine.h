@@ -0,0 +1,46 @@
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "AllocatorEngine.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  BuddyEngine Class Declaration                                                 |
+|   - Binary buddy system: blocks of 2^order words, aligned to their size        |
+|   - A memory block whose size is not a power of two starts out as the largest  |
+|     aligned power-of-two blocks that tile it                                   |
+|   - A free block's buddy is found by flipping bit 'order' of its offset, and   |
+|     a per-order bitmap tells in O(1) whether that buddy is free to merge with  |
+|   - Requests are rounded up to a power of two, the unused tail of a block     |
+|     stays allocated until the block is freed                                   |
+|--------------------------------------------------------------------------------|
+*/
+class BuddyEngine : public AllocatorEngine
+{
+ private:
+        size_t sizeInWords;                                   // words managed, from offset 0
+        unsigned orderCount;                                  // orders 0 .. orderCount - 1 (largest block is 2^(orderCount - 1) words)
+        std::vector<std::vector<uint64_t>> freeBits;          // per order: bit (offset >> order) set if a free block of that order starts at offset
+        std::vector<std::set<size_t>> freeLists;              // per order: offsets of free blocks (lowest handed out first)
+        uint64_t nonEmptyOrders = 0;                          // bit order set if freeLists[order] is not empty
+        std::vector<uint8_t> orderOf;                         // per word: 1 + order of the allocated block starting there, 0 otherwise
+
+ public:
+
+        // Constructor
+        explicit BuddyEngine(size_t sizeInWords);
+
+        // AllocatorEngine
+        int64_t allocate(size_t sizeInWords) override;
+        int64_t allocateAligned(size_t sizeInWords, size_t alignInWords, size_t phase) override;
+        size_t free(size_t offset) override;
+        size_t blockSize(size_t offset) const override;
+        void forEachHole(const std::function<void(size_t offset, size_t size)>& visit) const override;
+
+ private:
+        bool isFree(unsigned order, size_t offset) const;
+        void addFree(unsigned order, size_t offset);
+        void removeFree(unsigned order, size_t offset);
+};
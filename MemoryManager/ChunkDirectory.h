@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+/*
+|--------------------------------------------------------------------------------|
+|  ChunkDirectory Class Declaration                                              |
+|   - Maps address ranges [start, start + bytes) of chunks to their owner        |
+|   - find routes an address to the chunk holding it in O(log chunks)           |
+|   - Ranges may not overlap                                                     |
+|--------------------------------------------------------------------------------|
+*/
+template <typename Owner>
+class ChunkDirectory
+{
+ private:
+        struct Range
+        {
+                uintptr_t end;                        // one past the last byte of the chunk
+                Owner* owner;
+        };
+        std::map<uintptr_t, Range> ranges;            // first byte of each chunk -> its range
+
+ public:
+
+        // Mutators
+        void insert(const void* start, size_t bytes, Owner* owner)
+        {
+                ranges[(uintptr_t)start] = Range{(uintptr_t)start + bytes, owner};
+        }
+
+        void erase(const void* start)
+        {
+                ranges.erase((uintptr_t)start);
+        }
+
+        void clear()
+        {
+                ranges.clear();
+        }
+
+        // Owner of the chunk holding address, nullptr if no chunk does
+        Owner* find(const void* address) const
+        {
+                auto iter = ranges.upper_bound((uintptr_t)address);
+                if (iter == ranges.begin())
+                {
+                        return nullptr;
+                }
+                --iter;
+                return (uintptr_t)address < iter->second.end ? iter->second.owner : nullptr;
+        }
+
+        size_t count() const
+        {
+                return ranges.size();
+        }
+};
@@ -0,0 +1,467 @@
+#include "ConcurrentMemoryManager.h"
+
+#include <unordered_map>
+
+/*--------------------------------------------|
+|        Thread Cache Lookup                  |
+|--------------------------------------------*/
+
+static std::atomic<uint64_t> nextManagerId{1};
+
+// Managers not yet destroyed, by id (ids are never reused)
+static std::mutex liveManagersLock;
+static std::unordered_map<uint64_t, ConcurrentMemoryManager *> liveManagers;
+
+// Each thread's caches, by manager id (entries of destroyed managers are dropped by the next lookup that misses)
+// Destroyed when the thread exits, handing each cache back to its manager if that is still alive
+struct ThreadCacheTable
+{
+    std::unordered_map<uint64_t, void *> entries;
+
+    ~ThreadCacheTable()
+    {
+        std::lock_guard<std::mutex> guard(liveManagersLock);
+        for (auto &entry : entries)
+        {
+            auto manager = liveManagers.find(entry.first);
+            if (manager != liveManagers.end())
+            {
+                manager->second->retireCache(*static_cast<ConcurrentMemoryManager::ThreadCache *>(entry.second));
+            }
+        }
+    }
+};
+static thread_local ThreadCacheTable threadCaches;
+static thread_local uint64_t lastManagerId = 0;
+static thread_local void *lastCache = nullptr;
+
+// Bucket b holds blocks of 2^b words
+static inline unsigned bucketFor(size_t sizeInWords)
+{
+    return sizeInWords <= 1 ? 0 : 64 - __builtin_clzll(sizeInWords - 1);
+}
+
+// Drops the calling thread's entries for managers destroyed since they were made
+static void pruneThreadCaches()
+{
+    std::lock_guard<std::mutex> guard(liveManagersLock);
+    for (auto entry = threadCaches.entries.begin(); entry != threadCaches.entries.end();)
+    {
+        entry = liveManagers.count(entry->first) ? std::next(entry) : threadCaches.entries.erase(entry);
+    }
+}
+
+
+/*--------------------------------------------|
+| ConcurrentMemoryManager Class Definitions   |
+|--------------------------------------------*/
+
+/* CONTSTRUCTOR:
+Sets word size and allocator of the shared arena
+*/
+ConcurrentMemoryManager::ConcurrentMemoryManager(unsigned wordSize, std::function<int(int, void *)> allocator)
+    : manager(wordSize, allocator), id(nextManagerId++), wordSize(wordSize)
+{
+    std::lock_guard<std::mutex> guard(liveManagersLock);
+    liveManagers[id] = this;
+}
+
+ConcurrentMemoryManager::ConcurrentMemoryManager(unsigned wordSize, FitStrategy strategy)
+    : manager(wordSize, strategy), id(nextManagerId++), wordSize(wordSize)
+{
+    std::lock_guard<std::mutex> guard(liveManagersLock);
+    liveManagers[id] = this;
+}
+
+/* DESTRUCTOR:
+Releases the arena; cached blocks go with it
+The calling thread's entry for this manager is dropped now, other threads drop theirs at their next lookup that misses
+*/
+ConcurrentMemoryManager::~ConcurrentMemoryManager()
+{
+    {
+        std::lock_guard<std::mutex> guard(liveManagersLock);
+        liveManagers.erase(id);
+    }
+    threadCaches.entries.erase(id);
+    if (lastManagerId == id)
+    {
+        lastManagerId = 0;
+        lastCache = nullptr;
+    }
+    shutdown();
+}
+
+/* INITIALIZER:
+Instantiates the shared arena, cleans up previous one if applicable
+*/
+void ConcurrentMemoryManager::initialize(size_t sizeInWords)
+{
+    shutdown();
+    manager.initialize(sizeInWords);
+
+    start = static_cast<uint8_t *>(manager.getMemoryStart());
+    memLimit = manager.getMemoryLimit();
+    if (start)
+    {
+        bucketOf.reset(new std::atomic<uint8_t>[sizeInWords]());
+        ownerOf.reset(new std::atomic<uint8_t>[sizeInWords]());
+    }
+}
+
+/* RELEASER:
+Releases the arena & empties every thread's cache
+*/
+void ConcurrentMemoryManager::shutdown()
+{
+    for (auto &cache : caches)
+    {
+        for (auto &magazine : cache->magazines)
+        {
+            magazine.clear();
+        }
+        cache->remoteFrees.store(nullptr, std::memory_order_relaxed);
+    }
+    manager.shutdown();
+    bucketOf.reset();
+    ownerOf.reset();
+    start = nullptr;
+    memLimit = 0;
+}
+
+/* ALLOCATOR:
+Pops from the calling thread's magazine (taking in blocks freed by other threads first, refilling it in one locked batch when empty); large blocks come from the arena directly
+When the arena has no room, the calling thread's cached blocks (& blocks freed to exited threads) go back to it & the request is tried once more
+Returns nullptr if no memory available or invalid size
+*/
+void *ConcurrentMemoryManager::allocate(size_t sizeInBytes)
+{
+    size_t sizeInWords = (sizeInBytes + wordSize - 1) / wordSize;
+
+    if (sizeInWords == 0 || start == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (sizeInWords > maxCachedWords)
+    {
+        {
+            std::lock_guard<std::mutex> guard(arenaLock);
+            void *block = manager.allocate(sizeInBytes);
+            if (block != nullptr)
+            {
+                return block;
+            }
+        }
+
+        ThreadCache &cache = localCache();                    // may take the lock itself
+        std::lock_guard<std::mutex> guard(arenaLock);
+        returnCachedBlocks(cache);
+        return manager.allocate(sizeInBytes);
+    }
+
+    unsigned bucket = bucketFor(sizeInWords);
+    ThreadCache &cache = localCache();
+    std::vector<void *> &magazine = cache.magazines[bucket];
+
+    if (cache.remoteFrees.load(std::memory_order_relaxed) != nullptr)
+    {
+        drainRemoteFrees(cache);
+    }
+
+    if (magazine.empty())
+    {
+        refill(cache, bucket);
+        if (magazine.empty())
+        {
+            return nullptr;
+        }
+    }
+
+    void *block = magazine.back();
+    magazine.pop_back();
+    return block;
+}
+
+/* HINTED ALLOCATOR:
+Default blocks come from the thread cache as with allocate, other hints are placed by the arena under the lock (see AllocationHint)
+Hinted blocks are never cached, free returns them straight to the arena
+*/
+void *ConcurrentMemoryManager::allocate(size_t sizeInBytes, AllocationHint hint)
+{
+    if (hint == AllocationHint::Default)
+    {
+        return allocate(sizeInBytes);
+    }
+
+    std::lock_guard<std::mutex> guard(arenaLock);
+    return manager.allocate(sizeInBytes, hint);
+}
+
+/* DEALLOCATOR:
+Pushes cached-size blocks onto the calling thread's magazine (draining half of it in one locked batch when full)
+Blocks that came from another live thread's magazine go onto that thread's remote-free stack instead (one CAS, no lock)
+Other blocks go back to the arena under the lock
+*/
+void ConcurrentMemoryManager::free(void *address)
+{
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+
+    if (start == nullptr || byteAddress < start || byteAddress >= start + memLimit || (byteAddress - start) % wordSize != 0)
+    {
+        return;
+    }
+
+    uint8_t tag = bucketOf[(byteAddress - start) / wordSize].load(std::memory_order_relaxed);
+    if (tag == 0)
+    {
+        std::lock_guard<std::mutex> guard(arenaLock);
+        manager.free(address);
+        return;
+    }
+
+    unsigned bucket = tag - 1;
+    ThreadCache &cache = localCache();
+    uint8_t owner = ownerOf[(byteAddress - start) / wordSize].load(std::memory_order_relaxed);
+
+    // The link to the next remote free is kept in the block, so it needs room for a pointer
+    ThreadCache *ownerCache = (owner != 0 && owner != cache.ownerIndex) ? owners[owner - 1].load(std::memory_order_acquire) : nullptr;
+    if (ownerCache != nullptr && !ownerCache->retired.load(std::memory_order_acquire) && (size_t(1) << bucket) * wordSize >= sizeof(void *))
+    {
+        std::atomic<void *> &remoteFrees = ownerCache->remoteFrees;
+        void *head = remoteFrees.load(std::memory_order_relaxed);
+        do
+        {
+            memcpy(address, &head, sizeof(void *));
+        } while (!remoteFrees.compare_exchange_weak(head, address, std::memory_order_release, std::memory_order_relaxed));
+        return;
+    }
+
+    pushLocal(cache, bucket, address);
+}
+
+/* FLUSH THREAD CACHE:
+Returns every block cached by the calling thread to the arena, including blocks other threads freed remotely to it (done for each thread as it exits)
+*/
+void ConcurrentMemoryManager::flushThreadCache()
+{
+    ThreadCache &cache = localCache();
+    drainRemoteFrees(cache);
+    for (unsigned bucket = 0; bucket < bucketCount; bucket++)
+    {
+        drain(cache, bucket, 0);
+    }
+}
+
+/* SET QUARANTINE LIMIT:
+Sets the freed bytes the arena holds back in hardened builds (see MemoryManager::setQuarantineLimit), blocks in thread caches aside
+*/
+void ConcurrentMemoryManager::setQuarantineLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> guard(arenaLock);
+    manager.setQuarantineLimit(bytes);
+}
+
+// Helper function: the calling thread's cache for this manager, created on first use
+ConcurrentMemoryManager::ThreadCache &ConcurrentMemoryManager::localCache()
+{
+    if (lastManagerId == id)
+    {
+        return *static_cast<ThreadCache *>(lastCache);
+    }
+
+    auto found = threadCaches.entries.find(id);
+    if (found == threadCaches.entries.end())
+    {
+        pruneThreadCaches();                                  // keeps the table to managers still alive
+
+        // The cache of an exited thread is reused with its owner slot, blocks freed to it since are taken in at the first allocate
+        std::lock_guard<std::mutex> guard(arenaLock);
+        ThreadCache *cache;
+        if (!spareCaches.empty())
+        {
+            cache = spareCaches.back();
+            spareCaches.pop_back();
+            cache->retired.store(false, std::memory_order_release);
+        }
+        else
+        {
+            caches.emplace_back(new ThreadCache());
+            cache = caches.back().get();
+            if (ownerCount < maxOwners)
+            {
+                cache->ownerIndex = (uint8_t)(ownerCount + 1);
+                owners[ownerCount++].store(cache, std::memory_order_release);
+            }
+        }
+        found = threadCaches.entries.emplace(id, cache).first;
+    }
+
+    lastManagerId = id;
+    lastCache = found->second;
+    return *static_cast<ThreadCache *>(found->second);
+}
+
+// Helper function: moves up to batchSize fresh blocks of the bucket from the arena into the magazine, under one lock
+void ConcurrentMemoryManager::refill(ThreadCache &cache, unsigned bucket)
+{
+    size_t blockBytes = (size_t(1) << bucket) * wordSize;
+    std::vector<void *> &magazine = cache.magazines[bucket];
+    std::lock_guard<std::mutex> guard(arenaLock);
+
+    for (unsigned i = 0; i < batchSize; i++)
+    {
+        uint8_t *block = static_cast<uint8_t *>(manager.allocate(blockBytes));
+        if (block == nullptr && i == 0)
+        {
+            returnCachedBlocks(cache);
+            block = static_cast<uint8_t *>(manager.allocate(blockBytes));
+        }
+        if (block == nullptr)
+        {
+            break;
+        }
+        bucketOf[(block - start) / wordSize].store(bucket + 1, std::memory_order_relaxed);
+        ownerOf[(block - start) / wordSize].store(cache.ownerIndex, std::memory_order_relaxed);
+        magazine.push_back(block);
+    }
+}
+
+// Helper function: returns blocks of the bucket from the magazine to the arena until only keep are left, under one lock
+void ConcurrentMemoryManager::drain(ThreadCache &cache, unsigned bucket, size_t keep)
+{
+    std::vector<void *> &magazine = cache.magazines[bucket];
+    if (magazine.size() <= keep)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(arenaLock);
+    while (magazine.size() > keep)
+    {
+        uint8_t *block = static_cast<uint8_t *>(magazine.back());
+        magazine.pop_back();
+        bucketOf[(block - start) / wordSize].store(0, std::memory_order_relaxed);
+        manager.free(block);
+    }
+}
+
+// Helper function: takes every block other threads freed to this cache (one exchange) & puts them in its magazines
+void ConcurrentMemoryManager::drainRemoteFrees(ThreadCache &cache)
+{
+    void *block = cache.remoteFrees.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr)
+    {
+        void *next;
+        memcpy(&next, block, sizeof(void *));
+
+        unsigned bucket = bucketOf[(static_cast<uint8_t *>(block) - start) / wordSize].load(std::memory_order_relaxed) - 1;
+        pushLocal(cache, bucket, block);
+        block = next;
+    }
+}
+
+// Helper function: pushes a block onto the cache's magazine (draining half of it in one locked batch when full), the cache becomes its owner
+void ConcurrentMemoryManager::pushLocal(ThreadCache &cache, unsigned bucket, void *block)
+{
+    std::vector<void *> &magazine = cache.magazines[bucket];
+    if (magazine.size() >= magazineSize)
+    {
+        drain(cache, bucket, magazineSize - batchSize);
+    }
+
+    ownerOf[(static_cast<uint8_t *>(block) - start) / wordSize].store(cache.ownerIndex, std::memory_order_relaxed);
+    magazine.push_back(block);
+}
+
+// Helper function: returns the blocks of an exiting thread's cache to the arena & keeps the cache (with its owner slot) for the next new thread
+void ConcurrentMemoryManager::retireCache(ThreadCache &cache)
+{
+    // Other threads free the blocks it owns locally from here on
+    cache.retired.store(true, std::memory_order_release);
+    if (start != nullptr)
+    {
+        drainRemoteFrees(cache);
+        for (unsigned bucket = 0; bucket < bucketCount; bucket++)
+        {
+            drain(cache, bucket, 0);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(arenaLock);
+    spareCaches.push_back(&cache);
+}
+
+// Helper function: returns every block the cache holds (blocks freed to it remotely too) & the blocks freed to exited threads to the arena, so an allocation that did not fit can be tried again (arenaLock held)
+void ConcurrentMemoryManager::returnCachedBlocks(ThreadCache &cache)
+{
+    void *block = cache.remoteFrees.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr)
+    {
+        void *next;
+        memcpy(&next, block, sizeof(void *));
+
+        bucketOf[(static_cast<uint8_t *>(block) - start) / wordSize].store(0, std::memory_order_relaxed);
+        manager.free(block);
+        block = next;
+    }
+
+    for (auto &magazine : cache.magazines)
+    {
+        for (void *cached : magazine)
+        {
+            bucketOf[(static_cast<uint8_t *>(cached) - start) / wordSize].store(0, std::memory_order_relaxed);
+            manager.free(cached);
+        }
+        magazine.clear();
+    }
+    reclaimRetiredFrees();
+}
+
+// Helper function: returns blocks pushed onto retired caches by frees that raced with their thread's exit to the arena (arenaLock held)
+void ConcurrentMemoryManager::reclaimRetiredFrees()
+{
+    for (ThreadCache *cache : spareCaches)
+    {
+        void *block = cache->remoteFrees.exchange(nullptr, std::memory_order_acquire);
+        while (block != nullptr)
+        {
+            void *next;
+            memcpy(&next, block, sizeof(void *));
+
+            bucketOf[(static_cast<uint8_t *>(block) - start) / wordSize].store(0, std::memory_order_relaxed);
+            manager.free(block);
+            block = next;
+        }
+    }
+}
+
+/* GET LIST / GET BIT MAP:
+Snapshots of the arena taken under the lock (blocks in thread caches show as allocated)
+*/
+void *ConcurrentMemoryManager::getList()
+{
+    std::lock_guard<std::mutex> guard(arenaLock);
+    return manager.getList();
+}
+
+void *ConcurrentMemoryManager::getBitmap()
+{
+    std::lock_guard<std::mutex> guard(arenaLock);
+    return manager.getBitmap();
+}
+
+unsigned ConcurrentMemoryManager::getWordSize()
+{
+    return wordSize;
+}
+
+void *ConcurrentMemoryManager::getMemoryStart()
+{
+    return start;
+}
+
+size_t ConcurrentMemoryManager::getMemoryLimit()
+{
+    return memLimit;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "MemoryManager.h"
+
+struct ThreadCacheTable;
+
+/*
+|--------------------------------------------------------------------------------|
+|  ConcurrentMemoryManager Class Declaration                                     |
+|   - Thread-safe front-end over a MemoryManager                                 |
+|   - Blocks of up to maxCachedWords words are rounded up to a power-of-two size |
+|     bucket, each thread keeps a magazine of free blocks per bucket, and the    |
+|     shared arena is only locked to refill / drain a magazine in batches        |
+|   - Larger blocks go straight to the arena under the lock                      |
+|   - A block freed by a thread other than the one whose magazine it came from  |
+|     is pushed onto that thread's remote-free stack with one CAS (lock-free,    |
+|     many producers), the owner moves the whole stack into its magazines at    |
+|     its next allocate                                                          |
+|   - When a thread exits its cache goes back to the arena & the cache (with its |
+|     owner slot) is kept for the next thread, blocks it handed out are freed    |
+|     locally from then on                                                       |
+|   - When the arena has no room left, the calling thread's cached blocks go     |
+|     back to it & the allocation is tried once more                             |
+|   - Cached blocks count as allocated in getList / getBitmap                    |
+|--------------------------------------------------------------------------------|
+*/
+class ConcurrentMemoryManager
+{
+ public:
+        static const unsigned bucketCount = 7;                        // buckets of 1, 2, 4, ... 64 words
+        static const size_t maxCachedWords = size_t(1) << (bucketCount - 1);
+        static const unsigned magazineSize = 32;                      // most free blocks a thread keeps per bucket
+        static const unsigned batchSize = magazineSize / 2;           // blocks moved per refill / drain
+        static const unsigned maxOwners = 255;                        // live threads whose blocks are freed remotely (later threads free locally)
+
+ private:
+        struct ThreadCache
+        {
+                std::vector<void*> magazines[bucketCount];            // free blocks of each bucket, owned by one thread
+                uint8_t ownerIndex = 0;                               // 1 + index in owners, 0 if past maxOwners
+                std::atomic<bool> retired{false};                     // its thread has exited, blocks it owns are freed locally
+                alignas(64) std::atomic<void*> remoteFrees{nullptr};  // blocks freed by other threads, linked through their first bytes
+        };
+
+        MemoryManager manager;                                        // shared arena, only touched under arenaLock
+        std::mutex arenaLock;
+        std::unique_ptr<std::atomic<uint8_t>[]> bucketOf;             // per word: 1 + bucket of the cached-size block starting there, 0 otherwise
+        std::unique_ptr<std::atomic<uint8_t>[]> ownerOf;              // per word: ownerIndex of the cache the block starting there came from
+        std::atomic<ThreadCache*> owners[maxOwners] = {};             // caches by ownerIndex - 1 (read without the lock by remote frees)
+        unsigned ownerCount = 0;                                      // owners handed out (guarded by arenaLock)
+        std::vector<std::unique_ptr<ThreadCache>> caches;             // every thread's cache for this manager (guarded by arenaLock)
+        std::vector<ThreadCache*> spareCaches;                        // caches of exited threads, handed to the next new thread (guarded by arenaLock)
+        const uint64_t id;                                            // identifies this manager in each thread's cache lookup
+
+        uint8_t* start = nullptr;                                     // copies of the arena geometry, fixed between initialize & shutdown
+        size_t memLimit = 0;
+        unsigned wordSize;
+
+        ThreadCache& localCache();
+        void refill(ThreadCache& cache, unsigned bucket);
+        void drain(ThreadCache& cache, unsigned bucket, size_t keep);
+        void drainRemoteFrees(ThreadCache& cache);
+        void pushLocal(ThreadCache& cache, unsigned bucket, void* block);
+        void retireCache(ThreadCache& cache);
+        void returnCachedBlocks(ThreadCache& cache);
+        void reclaimRetiredFrees();
+
+        friend struct ThreadCacheTable;
+
+ public:
+
+        // Constructor / Destructor
+        ConcurrentMemoryManager(unsigned wordSize, std::function<int(int, void*)> allocator);
+        ConcurrentMemoryManager(unsigned wordSize, FitStrategy strategy);
+        ~ConcurrentMemoryManager();
+
+        // Initialize / Release Memory Block (not thread-safe, no other calls may run at the same time)
+        void initialize(size_t sizeInWords);
+        void shutdown();
+
+        // Allocate / Deallocate Sections Of Memory (thread-safe)
+        void* allocate(size_t sizeInBytes);
+        void* allocate(size_t sizeInBytes, AllocationHint hint);
+        void free(void* address);
+        void flushThreadCache();
+
+        // Set Functions (Mutators, thread-safe)
+        void setQuarantineLimit(size_t bytes);
+
+        // Get Functions (Accessors, thread-safe, results are snapshots)
+        void* getList();
+        void* getBitmap();
+        unsigned getWordSize();
+        void* getMemoryStart();
+        size_t getMemoryLimit();
+};
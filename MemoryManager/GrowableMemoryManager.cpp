@@ -0,0 +1,227 @@
+#include "GrowableMemoryManager.h"
+
+/*--------------------------------------------|
+|   GrowableMemoryManager Class Definitions   |
+|--------------------------------------------*/
+
+/* CONTSTRUCTOR:
+Sets word size & the allocator each chunk uses for finding a memory hole
+*/
+GrowableMemoryManager::GrowableMemoryManager(unsigned wordSize, std::function<int(int, void *)> allocator)
+    : wordSize(wordSize), algorithmType(allocator)
+{
+}
+
+GrowableMemoryManager::GrowableMemoryManager(unsigned wordSize, FitStrategy strategy)
+    : wordSize(wordSize), fitStrategy(strategy)
+{
+}
+
+/* DESTRUCTOR:
+Releases every chunk
+*/
+GrowableMemoryManager::~GrowableMemoryManager()
+{
+    shutdown();
+}
+
+/* INITIALIZER:
+Sets the size of regular chunks & maps the first one, cleans up previous chunks if applicable
+*/
+void GrowableMemoryManager::initialize(size_t chunkSizeInWords)
+{
+    shutdown();
+    if (chunkSizeInWords == 0)
+    {
+        return;
+    }
+
+    this->chunkSizeInWords = chunkSizeInWords;
+    lastChunk = addChunk(chunkSizeInWords);
+    if (lastChunk == nullptr)
+    {
+        this->chunkSizeInWords = 0;
+    }
+}
+
+/* RELEASER:
+Releases every chunk (blocks in them are gone)
+*/
+void GrowableMemoryManager::shutdown()
+{
+    chunks.clear();
+    directory.clear();
+    chunkSizeInWords = 0;
+    lastChunk = nullptr;
+    spareChunk = nullptr;
+}
+
+/* ALLOCATOR:
+Allocates from the chunk used last, then from any other chunk with a large enough hole, then from a newly mapped chunk
+Returns nullptr if nothing was requested, before initialize, or if no new chunk can be mapped
+*/
+void *GrowableMemoryManager::allocate(size_t sizeInBytes)
+{
+    if (chunkSizeInWords == 0)
+    {
+        return nullptr;
+    }
+
+    // Words the block takes in a chunk, hardened builds add a guard word (a spare is never released, so there always is a chunk)
+    size_t sizeInWords = chunks.front()->wordsFor(sizeInBytes);
+    if (sizeInWords == 0)
+    {
+        return nullptr;
+    }
+
+    void *address = lastChunk ? lastChunk->allocate(sizeInBytes) : nullptr;
+
+    // The largest hole of each chunk tells whether trying it can succeed
+    for (size_t i = 0; address == nullptr && i < chunks.size(); i++)
+    {
+        MemoryManager *chunk = chunks[i].get();
+        if (chunk != lastChunk && chunk->getHoleIndex().findWorstFit(sizeInWords) != -1)
+        {
+            address = chunk->allocate(sizeInBytes);
+            lastChunk = address ? chunk : lastChunk;
+        }
+    }
+
+    if (address == nullptr)
+    {
+        MemoryManager *chunk = addChunk(std::max(chunkSizeInWords, sizeInWords));
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+        lastChunk = chunk;
+        address = chunk->allocate(sizeInBytes);
+    }
+
+    if (lastChunk == spareChunk)
+    {
+        spareChunk = nullptr;                       // the spare is in use again
+    }
+    return address;
+}
+
+/* DEALLOCATOR:
+Frees the block in the chunk holding it; an emptied chunk becomes the spare, or is released if there already is one
+*/
+void GrowableMemoryManager::free(void *address)
+{
+    MemoryManager *chunk = directory.find(address);
+    if (chunk == nullptr)
+    {
+        return;
+    }
+
+    chunk->free(address);
+    if (chunk == spareChunk || !isEmpty(chunk))
+    {
+        return;
+    }
+
+    if (spareChunk == nullptr)
+    {
+        spareChunk = chunk;
+    }
+    else
+    {
+        releaseChunk(chunk);
+    }
+}
+
+/* SET BACKING STORE:
+Changes the store new chunks are mapped from (Mmap by default, so released chunks go back to the OS)
+*/
+void GrowableMemoryManager::setBackingStore(BackingStore type)
+{
+    backingStore = type;
+}
+
+/* GET WORD SIZE:
+Returns word size used for alignment
+*/
+unsigned GrowableMemoryManager::getWordSize()
+{
+    return wordSize;
+}
+
+/* GET MEMORY LIMIT:
+Returns the bytes in all chunks currently mapped
+*/
+size_t GrowableMemoryManager::getMemoryLimit()
+{
+    size_t memLimit = 0;
+    for (auto &chunk : chunks)
+    {
+        memLimit += chunk->getMemoryLimit();
+    }
+    return memLimit;
+}
+
+/* GET CHUNK COUNT:
+Returns the number of chunks currently mapped
+*/
+size_t GrowableMemoryManager::getChunkCount()
+{
+    return chunks.size();
+}
+
+/* GET CHUNK:
+Returns a chunk by index (in the order they were mapped), e.g. for its getList / getBitmap
+*/
+MemoryManager &GrowableMemoryManager::getChunk(size_t index)
+{
+    return *chunks[index];
+}
+
+/* FIND CHUNK:
+Returns the chunk holding address, nullptr if no chunk does
+*/
+MemoryManager *GrowableMemoryManager::findChunk(void *address)
+{
+    return directory.find(address);
+}
+
+// Helper function: maps a chunk of sizeInWords words & records its address range, returns nullptr if the backing store fails
+MemoryManager *GrowableMemoryManager::addChunk(size_t sizeInWords)
+{
+    std::unique_ptr<MemoryManager> chunk(fitStrategy ? new MemoryManager(wordSize, fitStrategy) : new MemoryManager(wordSize, algorithmType));
+    chunk->setBackingStore(backingStore);
+    chunk->initialize(sizeInWords);
+    if (chunk->getMemoryStart() == nullptr)
+    {
+        return nullptr;
+    }
+
+    directory.insert(chunk->getMemoryStart(), chunk->getMemoryLimit(), chunk.get());
+    chunks.push_back(std::move(chunk));
+    return chunks.back().get();
+}
+
+// Helper function: unmaps a chunk & forgets its address range
+void GrowableMemoryManager::releaseChunk(MemoryManager *chunk)
+{
+    directory.erase(chunk->getMemoryStart());
+    if (lastChunk == chunk)
+    {
+        lastChunk = nullptr;
+    }
+
+    for (auto iter = chunks.begin(); iter != chunks.end(); ++iter)
+    {
+        if (iter->get() == chunk)
+        {
+            chunks.erase(iter);
+            break;
+        }
+    }
+}
+
+// Helper function: whether a chunk holds no block (quarantined blocks of hardened builds are freed already)
+bool GrowableMemoryManager::isEmpty(MemoryManager *chunk)
+{
+    return chunk->isEmpty();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+
+#include "MemoryManager.h"
+#include "ChunkDirectory.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  GrowableMemoryManager Class Declaration                                       |
+|   - MemoryManager made of chunks, each a MemoryManager with its own hole index |
+|   - When no chunk can hold a request, a new chunk is mapped (chunkSizeInWords  |
+|     words, or the words the request takes if more, see MemoryManager::        |
+|     wordsFor) instead of returning nullptr                                     |
+|   - free finds the chunk of an address through a ChunkDirectory                |
+|   - A chunk that becomes empty is kept as a spare while no other spare exists, |
+|     otherwise it is released (unmapped), so memory use follows the blocks in  |
+|     use without remapping at every alloc / free at the edge of a chunk        |
+|--------------------------------------------------------------------------------|
+*/
+class GrowableMemoryManager
+{
+ private:
+        unsigned wordSize;
+        std::function<int(int, void*)> algorithmType; // allocator given to each chunk (if no fitStrategy)
+        FitStrategy fitStrategy;                      // fit strategy given to each chunk
+        BackingStore backingStore = BackingStore::Mmap;   // store chunks are mapped from
+
+        size_t chunkSizeInWords = 0;                  // words in a regular chunk, 0 before initialize
+        std::vector<std::unique_ptr<MemoryManager>> chunks;   // chunks in the order they were mapped
+        ChunkDirectory<MemoryManager> directory;      // address range of each chunk
+        MemoryManager* lastChunk = nullptr;           // chunk the last allocation came from (tried first)
+        MemoryManager* spareChunk = nullptr;          // empty chunk kept mapped, nullptr if none
+
+ public:
+
+        // Constructor / Destructor
+        GrowableMemoryManager(unsigned wordSize, std::function<int(int, void*)> allocator);
+        GrowableMemoryManager(unsigned wordSize, FitStrategy strategy);
+        ~GrowableMemoryManager();
+
+        // Initialize / Release All Chunks (initialize maps the first chunk)
+        void initialize(size_t chunkSizeInWords);
+        void shutdown();
+
+        // Allocate / Deallocate Sections Of Memory
+        void* allocate(size_t sizeInBytes);
+        void free(void* address);
+
+        // Set Functions (Mutators)
+        void setBackingStore(BackingStore type);
+
+        // Get Functions (Accessors)
+        unsigned getWordSize();
+        size_t getMemoryLimit();
+        size_t getChunkCount();
+        MemoryManager& getChunk(size_t index);
+        MemoryManager* findChunk(void* address);
+
+ private:
+        MemoryManager* addChunk(size_t sizeInWords);
+        void releaseChunk(MemoryManager* chunk);
+        bool isEmpty(MemoryManager* chunk);
+};
@@ -1,4 +1,67 @@
 #include "MemoryManager.h"
+#include "BuddyEngine.h"
+#include "TlsfEngine.h"
+
+#include <cstdlib>
+
+/*-------------------------------------------|
+|  Hardened Build Switches                   |
+|-------------------------------------------*/
+#ifdef MEMORY_MANAGER_HARDENED
+static const bool hardened = true;
+#else
+static const bool hardened = false;
+#endif
+static const size_t guardBytes = hardened ? 8 : 0;  // canary bytes added to every request
+static const uint8_t guardByte = 0xCA;              // value of canary bytes
+static const uint8_t freedByte = 0xDD;              // value of free words
+static const size_t quarantineShare = 8;            // the quarantine holds at most 1 / quarantineShare of memory
+
+// ASan / Valgrind client requests, only in hardened builds under those tools
+#ifdef MEMORY_MANAGER_HARDENED
+#if defined(__SANITIZE_ADDRESS__)
+#define MEMORY_MANAGER_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define MEMORY_MANAGER_ASAN
+#endif
+#endif
+#ifdef MEMORY_MANAGER_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+#if defined(__has_include)
+#if __has_include(<valgrind/memcheck.h>)
+#include <valgrind/memcheck.h>
+#define MEMORY_MANAGER_VALGRIND
+#endif
+#endif
+#endif
+
+// Helper function: marks bytes unaddressable for ASan / Valgrind (no-op when not running under them)
+static void hideBytes(void *address, size_t bytes)
+{
+    (void)address;
+    (void)bytes;
+#ifdef MEMORY_MANAGER_ASAN
+    __asan_poison_memory_region(address, bytes);
+#endif
+#ifdef MEMORY_MANAGER_VALGRIND
+    VALGRIND_MAKE_MEM_NOACCESS(address, bytes);
+#endif
+}
+
+// Helper function: marks bytes addressable (and their contents defined) again for ASan / Valgrind
+static void exposeBytes(void *address, size_t bytes)
+{
+    (void)address;
+    (void)bytes;
+#ifdef MEMORY_MANAGER_ASAN
+    __asan_unpoison_memory_region(address, bytes);
+#endif
+#ifdef MEMORY_MANAGER_VALGRIND
+    VALGRIND_MAKE_MEM_DEFINED(address, bytes);
+#endif
+}
 
 /*-------------------------------------------|
 |  Memory Allocation Algorithm Definitions   |
@@ -46,324 +109,2873 @@ int worstFit(int sizeInWords, void *list)
     return offset;
 }
 
+/* WIDE BEST FIT ALGORITHM
+- Same as bestFit, reading a Wide64 hole list
+*/
+int64_t bestFitWide(size_t sizeInWords, const uint64_t *list)
+{
+    int64_t offset = -1;
+    uint64_t max = UINT64_MAX;
+    uint64_t holeListLength = *list++;
 
-/*--------------------------------------------|
-|      MemoryManager Class Definitions        |
-|--------------------------------------------*/
+    for (uint64_t i = 1; i < (holeListLength)*2; i += 2)
+    {
+        if (list[i] >= sizeInWords && list[i] < max)
+        {
+            offset = list[i - 1];
+            max = list[i];
+        }
+    }
+    return offset;
+}
 
-/* CONTSTRUCTOR:
-Sets naive word size (in bytes, for alignment) and default allocator for finding a memory hole
+/* WIDE WORST FIT ALGORITHM
+- Same as worstFit, reading a Wide64 hole list
 */
-MemoryManager::MemoryManager(unsigned wordSize, std::function<int(int, void *)> allocator) 
+int64_t worstFitWide(size_t sizeInWords, const uint64_t *list)
 {
-    this->algorithmType = allocator;    // algorithm type used
-    this->wordSize = wordSize;          // # of words
+    int64_t offset = -1;
+    uint64_t min = 0;
+    uint64_t holeListLength = *list++;
+
+    for (uint64_t i = 1; i < (holeListLength)*2; i += 2)
+    {
+        if (list[i] >= sizeInWords && (offset == -1 || list[i] > min))
+        {
+            offset = list[i - 1];
+            min = list[i];
+        }
+    }
+    return offset;
 }
 
-/* DESTRUCTOR:
-Releases all memory allocated by this object WITHOUT LEAKING MEMORY!!
+/* INDEXED BEST FIT STRATEGY
+- Same hole as bestFit, found with a lower_bound on the size-ordered hole index instead of a scan
 */
-MemoryManager::~MemoryManager()
+int64_t indexedBestFit(size_t sizeInWords, const HoleIndex &holes)
 {
-    // Call the release (shutdown) function to empty the vectors representing the currently allocated memory
-    shutdown();
+    return holes.findBestFit(sizeInWords);
 }
 
-/* INITIALIZER:
-Instantiates a block of requested size, no larger than 65536 words, cleans up previous block if applicable
+/* INDEXED WORST FIT STRATEGY
+- Same hole as worstFit, found from the largest entry of the size-ordered hole index instead of a scan
 */
-void MemoryManager::initialize(size_t sizeInWords)
+int64_t indexedWorstFit(size_t sizeInWords, const HoleIndex &holes)
 {
-    // Initially, check requirement that requested block size is no larger than 65536 words
-    if (sizeInWords <= 65536)
-    {
-        memLimit = wordSize * sizeInWords;                    // calculate memory limit (# of bytes available) by multiplying # of words & bytes per word
-        memoryBlock = std::vector<uint64_t>(memLimit);        // allocate a memoryBlock of that many bytes
-        start = (uint64_t *)memoryBlock.data();               // set start to be the address of first element in memoryBlock
-        indexToNodeMap[0] = 0;                                // initialize mapping to 0   
-        listNodes.push_back(listNode(0, sizeInWords, true));  // add node to the listNodes vector with start(0),  blockSize(sizeInWords) & isHole(true)
-    }
+    return holes.findWorstFit(sizeInWords);
 }
 
-/* RELEASER:
-Releases memory block acquired during initialization, if any. Does this WITHOUT LEAKING MEMORY
+
+/* BITMAP FIRST FIT STRATEGY
+- Returns word offset of the first run of sizeInWords free words in the occupancy bitmap
 */
-void MemoryManager::shutdown()
+int64_t bitmapFirstFit(size_t sizeInWords, const HoleIndex &holes)
 {
-    // Empty the respective vectors representing the memoryBlock, the list of nodes, and the map of nodes to locations in memory
-    listNodes.clear();
-    memoryBlock.clear();
-    indexToNodeMap.clear();
+    const OccupancyBitmap &occupancy = holes.getOccupancy();
+    return findFreeRun(occupancy.data(), occupancy.size(), sizeInWords);
 }
 
-/* ALLOCATOR:
-Allocates a memory using the allocator function; If no memory available or invalid size, returns nullptr
+/* BITMAP NEXT FIT STRATEGY
+- Returns word offset of the first run of sizeInWords free words at or after the end of the last allocation,
+  wrapping around to the start of memory if there is none
 */
-void *MemoryManager::allocate(size_t sizeInBytes)
+int64_t BitmapNextFit::operator()(size_t sizeInWords, const HoleIndex &holes)
 {
-    size_t sizeInWords = ceil((float)sizeInBytes / wordSize);           // Gets the sizeInWords from dividing sizeInBytes by length of words
-    uint16_t *newListPtr = static_cast<uint16_t *>(getList());          // Creates pointer to list created from getList(), which memory with 'new'
-    int availableHole = algorithmType(sizeInWords, newListPtr);         // Uses specified algorithm to find a hole in memory suitable for allocation
-    delete[] newListPtr;                                                // 'delete' allocated memory from getList (PREVENTS MEMORY LEAKS)
+    const OccupancyBitmap &occupancy = holes.getOccupancy();
+    int64_t offset = -1;
 
-    // Return nullptr, if failed to find availableHole or invalid size
-    if (availableHole == -1 || indexToNodeMap.count(availableHole) == 0)
+    if (cursor < occupancy.size())
     {
-        return nullptr;
+        offset = findFreeRun(occupancy.data(), occupancy.size(), sizeInWords, cursor);
     }
+    if (offset == -1)
+    {
+        offset = findFreeRun(occupancy.data(), occupancy.size(), sizeInWords);
+    }
+    return offset;
+}
 
-    int nodeIndex = indexToNodeMap[availableHole];
+// Moves the cursor past a block the manager claimed
+void BitmapNextFit::claimed(size_t offset, size_t sizeInWords)
+{
+    cursor = offset + sizeInWords;
+}
 
-    // if there is more space, allocate and split listNode
-    if (listNodes[nodeIndex].size != sizeInWords)
+
+/*--------------------------------------------|
+|     OccupancyBitmap Class Definitions       |
+|--------------------------------------------*/
+
+// Tracks sizeInWords words of memory, all of them free
+void OccupancyBitmap::reset(size_t sizeInWords)
+{
+    this->sizeInWords = sizeInWords;
+    bits.assign((sizeInWords + 63) / 64, 0);
+}
+
+void OccupancyBitmap::clear()
+{
+    sizeInWords = 0;
+    std::vector<uint64_t>().swap(bits);
+}
+
+// Sets the bits of words [offset, offset + size), filling whole uint64_t at a time between the two partial ends
+void OccupancyBitmap::markUsed(size_t offset, size_t size)
+{
+    if (size == 0)
     {
-        splitNode(nodeIndex, availableHole, sizeInWords);
+        return;
     }
-    else
+
+    size_t first = offset / 64;
+    size_t last = (offset + size - 1) / 64;
+    uint64_t firstMask = ~0ULL << (offset % 64);
+    uint64_t lastMask = ~0ULL >> (63 - (offset + size - 1) % 64);
+
+    if (first == last)
     {
-        listNodes[nodeIndex].isHole = false;
+        bits[first] |= firstMask & lastMask;
+        return;
     }
-    return (void *)(memoryBlock.data() + availableHole);                // Return pointer to allocated memoryBlock
+
+    bits[first] |= firstMask;
+    std::fill(bits.begin() + first + 1, bits.begin() + last, ~0ULL);
+    bits[last] |= lastMask;
 }
 
-// Helper allocate function: splits listNode in linked list of allocated memory blocks, creating new node to represent the allocated block & updates as needed
-void MemoryManager::splitNode(int nodeIndex, int availableHole, size_t sizeInWords)
+// Clears the bits of words [offset, offset + size)
+void OccupancyBitmap::markFree(size_t offset, size_t size)
 {
-    // Create listNode representing allocated memory block
-    listNode usedNode = listNode(listNodes[nodeIndex].headIndex, sizeInWords, false);
-    listNodes.insert(listNodes.begin() + nodeIndex, usedNode);
-
-    // Update previous listNodes
-    listNodes[nodeIndex + 1].headIndex += sizeInWords;
-    listNodes[nodeIndex + 1].size -= sizeInWords;
+    if (size == 0)
+    {
+        return;
+    }
 
-    // Update map
-    indexToNodeMap[listNodes[nodeIndex].headIndex] = nodeIndex;
-    indexToNodeMap[listNodes[nodeIndex + 1].headIndex] = nodeIndex + 1;
+    size_t first = offset / 64;
+    size_t last = (offset + size - 1) / 64;
+    uint64_t firstMask = ~0ULL << (offset % 64);
+    uint64_t lastMask = ~0ULL >> (63 - (offset + size - 1) % 64);
 
-    //  Iterate over indexToNodeMap to update indices of all nodes after the newly inserted node (to represent correct position in the linked list after the insertion)
-    for (auto iter = indexToNodeMap.find(listNodes[nodeIndex + 1].headIndex); iter != indexToNodeMap.end(); iter++)
+    if (first == last)
     {
-        if (iter == indexToNodeMap.find(listNodes[nodeIndex + 1].headIndex))
-        {
-            // Ignore first item
-            continue;
-        }
-        else
-        {
-            iter->second++;
-        }
+        bits[first] &= ~(firstMask & lastMask);
+        return;
     }
+
+    bits[first] &= ~firstMask;
+    std::fill(bits.begin() + first + 1, bits.begin() + last, 0ULL);
+    bits[last] &= ~lastMask;
 }
 
-/* DEALLOCATOR:
-Frees the memory block within the memory manager so it can be reused
-*/
-void MemoryManager::free(void *address)
+bool OccupancyBitmap::isUsed(size_t offset) const
 {
-    // Find node and make it a hole
-    int bytePosition = (uint64_t *)address - memoryBlock.data();
+    return (bits[offset / 64] >> (offset % 64)) & 1;
+}
+
+size_t OccupancyBitmap::size() const
+{
+    return sizeInWords;
+}
+
+const uint64_t *OccupancyBitmap::data() const
+{
+    return bits.data();
+}
+
+size_t OccupancyBitmap::blockCount() const
+{
+    return bits.size();
+}
 
-    // If no associated hole, return
-    if (indexToNodeMap.count(bytePosition) == 0)
+
+/*--------------------------------------------|
+|        HoleIndex Class Definitions          |
+|--------------------------------------------*/
+
+// Records a hole of size words starting at word offset (replaces any hole already recorded there)
+void HoleIndex::insert(size_t offset, size_t size)
+{
+    auto iter = holesByOffset.find(offset);
+    if (iter != holesByOffset.end())
     {
-        return;
+        holesBySize.erase({iter->second, offset});
+        record(offset, iter->second, false);
+        iter->second = size;
+    }
+    else
+    {
+        holesByOffset.emplace(offset, size);
     }
+    holesBySize.insert({size, offset});
+    record(offset, size, true);
+    updateLargest(offset);
+}
 
-    // Create nodeIndex corresponding to index in map from byteIndex
-    int nodePosition = indexToNodeMap[bytePosition];
-    listNodes[nodePosition].isHole = true;
+// Removes the hole starting at word offset, if any
+void HoleIndex::erase(size_t offset)
+{
+    auto iter = holesByOffset.find(offset);
+    if (iter != holesByOffset.end())
+    {
+        holesBySize.erase({iter->second, offset});
+        record(offset, iter->second, false);
+        holesByOffset.erase(iter);
+        updateLargest(offset);
+    }
+}
 
-    // combine holes if necessary
-    mergeHoles(nodePosition);
+// Removes every hole, the journal restarts after it (pollers read the holes again)
+void HoleIndex::clear()
+{
+    holesByOffset.clear();
+    holesBySize.clear();
+    occupancy.clear();
+    std::vector<size_t>().swap(largestHoles);
+    leafBase = 0;
+    generation++;
+    journalFloor = generation;
 }
 
-// Helper deallocate function, merges adjacent holes in memory
-void MemoryManager:: mergeHoles(int nodePosition)
+// Helper function: counts a change & keeps it in the journal, if tracking
+void HoleIndex::record(size_t offset, size_t size, bool added)
 {
-    if (nodePosition > 0 && listNodes[nodePosition - 1].isHole)
+    generation++;
+    if (!journal.empty())
     {
-        // If prev is a hole, merge holes
-        indexToNodeMap.erase(listNodes[nodePosition].headIndex);
-        listNodes[nodePosition - 1].size += listNodes[nodePosition].size;     // merge holes with prev
-        listNodes.erase(listNodes.begin() + nodePosition);                    // remove current
-
-        nodePosition--;    // decrement in case next is also a hole
+        journal[generation % journal.size()] = {generation, offset, size, added};
     }
-    else if (listNodes.size() > nodePosition && listNodes[nodePosition + 1].isHole)
+}
+
+// Changes from here on are kept, the last capacity of them at a time
+void HoleIndex::trackChanges(size_t capacity)
+{
+    if (journal.empty() && capacity != 0)
     {
-        // Else if next is a hole, merge holes
-        for (auto iter = indexToNodeMap.find(listNodes[nodePosition + 1].headIndex); iter != indexToNodeMap.end(); iter++)
-        {
-            iter->second--;
-        }
-        indexToNodeMap.erase(listNodes[nodePosition + 1].headIndex);
-        listNodes[nodePosition].size += listNodes[nodePosition + 1].size;     // merge holes with next
-        listNodes.erase(listNodes.begin() + nodePosition + 1);                // remove current
+        journal.resize(capacity);
+        journalFloor = generation;
     }
 }
 
-/* SET ALGORTIHM TYPE:
-Changes the allocator algorithm of identifying the memory hole to use for allocation       
-*/
-void MemoryManager::setAllocator(std::function<int(int, void *)> allocator)
+uint64_t HoleIndex::getGeneration() const
 {
-    this->algorithmType = allocator;
+    return generation;
 }
 
-/* ADD HOLE LIST TO FILENAME:
-Uses standard POSIX calls to write hole list to filename AS TEXT, returns -1 on error & 0 if successful
-*/
-int MemoryManager::dumpMemoryMap(char *filename)
+// Changes after generation since, if the journal still holds all of them
+bool HoleIndex::forEachChange(uint64_t since, const std::function<void(const HoleChange &change)> &visit) const
 {
-    // use POSIX calls to write holeList to file
-    int file = open(filename, O_CREAT | O_WRONLY, 0600);
-    if (file < 0)
+    uint64_t oldest = std::max<uint64_t>(journalFloor, generation > journal.size() ? generation - journal.size() : 0);
+    if (journal.empty() || since < oldest || since > generation)
     {
-        return -1;
+        return false;
+    }
+    for (uint64_t next = since + 1; next <= generation; next++)
+    {
+        visit(journal[next % journal.size()]);
     }
+    return true;
+}
 
-    std::string outputStr = "";
-    uint16_t *holeList = static_cast<uint16_t *>(getList());   // call to getList, allocates memory with 'new' 
-    uint16_t *listEntryPoint = holeList;
-    uint16_t holeListlength = *holeList++;
+OccupancyBitmap &HoleIndex::getOccupancy()
+{
+    return occupancy;
+}
+
+const OccupancyBitmap &HoleIndex::getOccupancy() const
+{
+    return occupancy;
+}
+
+size_t HoleIndex::count() const
+{
+    return holesByOffset.size();
+}
+
+HoleIndex::const_iterator HoleIndex::begin() const
+{
+    return holesByOffset.begin();
+}
 
-    // For each pair of data in holeList add them to outputStr and surround them in brackets
-    for (uint16_t i = 0; i < (holeListlength)*2; i += 2)
+HoleIndex::const_iterator HoleIndex::end() const
+{
+    return holesByOffset.end();
+}
+
+// Smallest hole of at least sizeInWords words
+int64_t HoleIndex::findBestFit(size_t sizeInWords) const
+{
+    auto iter = holesBySize.lower_bound({sizeInWords, 0});
+    return iter == holesBySize.end() ? -1 : (int64_t)iter->second;
+}
+
+// Hole whose words include offset
+int64_t HoleIndex::findContaining(size_t offset) const
+{
+    auto iter = holesByOffset.upper_bound(offset);
+    if (iter == holesByOffset.begin())
     {
-        outputStr += "[" + std::to_string(holeList[i]) + ", " + std::to_string(holeList[i + 1]) + "] - ";
+        return -1;
     }
+    --iter;
+    return (offset < iter->first + iter->second) ? (int64_t)iter->first : -1;
+}
 
-    outputStr = outputStr.substr(0, outputStr.size() - 3);
+// First hole at or after offset
+int64_t HoleIndex::findNext(size_t offset) const
+{
+    auto iter = holesByOffset.lower_bound(offset);
+    return iter == holesByOffset.end() ? -1 : (int64_t)iter->first;
+}
 
-    const char *c = outputStr.c_str();
-    delete[] listEntryPoint;            // Delete memory previously allocated in getList (PREVENTS LEAKS)
+// Highest-offset hole of at least sizeInWords words
+int64_t HoleIndex::findLastFit(size_t sizeInWords) const
+{
+    if (largestHoles.empty())
+    {
+        for (auto iter = holesByOffset.rbegin(); iter != holesByOffset.rend(); ++iter)
+        {
+            if (iter->second >= sizeInWords)
+            {
+                return (int64_t)iter->first;
+            }
+        }
+        return -1;
+    }
 
-    // Return -1, if write operation or close operation fail
-    if (write(file, c, strlen(c)) == -1 || close(file) == -1)
+    // Walk down to the highest leaf holding a hole that fits, preferring the right child
+    if (largestHoles[1] < sizeInWords)
     {
         return -1;
     }
-    else 
+    size_t node = 1;
+    while (node < leafBase)
     {
-        // Return 0, if successful
-        return 0;
+        node = largestHoles[2 * node + 1] >= sizeInWords ? 2 * node + 1 : 2 * node;
+    }
+
+    // The hole is among the few starting in that leaf's words
+    auto iter = holesByOffset.lower_bound((node - leafBase + 1) * lastFitLeafWords);
+    while (iter != holesByOffset.begin())
+    {
+        --iter;
+        if (iter->second >= sizeInWords)
+        {
+            return (int64_t)iter->first;
+        }
     }
+    return -1;
 }
 
-/* GET LIST:
-Returns an array of information (in decimal) about holes for use by the allocator function, if no memory has been allocated, returns nullptr
-*/
-void *MemoryManager::getList()
+// Builds the max tree from the current holes, later inserts & erases keep it up to date
+void HoleIndex::indexLastFit()
 {
-    // Return nullptr, if listNodes is empty (no memory allocated)
-    if (listNodes.size() == 0)
+    if (!largestHoles.empty() || occupancy.size() == 0)
     {
-        return nullptr;
+        return;
     }
-    
-    // Create vector representing list of holes in memory
-    std::vector<int> holeList;
-    int holeCount = 0;
 
-    // For each item in list nodes, if its a hole add it to holeList
-    for (unsigned int i = 0; i < listNodes.size(); i++)
+    size_t leaves = (occupancy.size() + lastFitLeafWords - 1) / lastFitLeafWords;
+    for (leafBase = 1; leafBase < leaves; leafBase *= 2)
     {
-        if (listNodes[i].isHole)
-        {
-            holeCount++;
-            holeList.push_back(listNodes[i].headIndex);
-            holeList.push_back(listNodes[i].size);
-        }
     }
-    holeList.insert(holeList.begin(), holeCount);
-    uint16_t *list = new uint16_t[1 + (holeCount * 2)];             // Allocate memory for 'list' which points to an array containing the holes in memory
-
-    // For each hole in hole list add it to newly allocated list
-    for (int i = 0; i < holeList.size(); i++)
+    largestHoles.assign(2 * leafBase, 0);
+    for (auto &hole : holesByOffset)
     {
-        list[i] = (uint16_t)holeList[i];
+        size_t &leaf = largestHoles[leafBase + hole.first / lastFitLeafWords];
+        leaf = std::max(leaf, hole.second);
+    }
+    for (size_t node = leafBase - 1; node > 0; node--)
+    {
+        largestHoles[node] = std::max(largestHoles[2 * node], largestHoles[2 * node + 1]);
     }
-    return list;
 }
 
-/* GET BIT MAP:
-Returns a bit-stream in terms of an array representing whether words are used (1) or free (0)
-First 2 bytes are size of bitmap, rest is the bitmap
-*/
-void *MemoryManager::getBitmap()
+// Helper function: recomputes the leaf holding word offset & its ancestors, stopping once a node is unchanged
+void HoleIndex::updateLargest(size_t offset)
 {
-    std::string binaryStr = "";
-    std::vector<std::string> binaryVec;
+    if (largestHoles.empty())
+    {
+        return;
+    }
 
-    // For each node in listNodes, set binary value based on if its a hole or is used
-    for (auto currNode : listNodes)
+    size_t leaf = offset / lastFitLeafWords;
+    size_t largest = 0;
+    for (auto iter = holesByOffset.lower_bound(leaf * lastFitLeafWords); iter != holesByOffset.end() && iter->first < (leaf + 1) * lastFitLeafWords; ++iter)
     {
-        int listLength = currNode.size;
-        while (listLength > 0)
-        {
-            if (currNode.isHole)
-            {
-                binaryStr = "0" + binaryStr;
-            }
-            else
-            {
-                binaryStr = "1" + binaryStr;
-            }
-            listLength--;
-        }
+        largest = std::max(largest, iter->second);
     }
-    
-    int sizeMap = (binaryStr.size() + 8 - 1) / 8;
 
-    // While binary string isnt empty add 8-bit string to binaryVec
-    while (binaryStr.size() > 0)
+    size_t node = leafBase + leaf;
+    largestHoles[node] = largest;
+    for (node /= 2; node > 0; node /= 2)
     {
-        if (binaryStr.size() > 8)
-        {
-            binaryVec.push_back(binaryStr.substr(binaryStr.size() - 8));
-            binaryStr = binaryStr.substr(0, binaryStr.size() - 8);
-        }
-        else
+        size_t value = std::max(largestHoles[2 * node], largestHoles[2 * node + 1]);
+        if (largestHoles[node] == value)
         {
-            binaryVec.push_back(binaryStr);
-            binaryStr.clear();
+            break;
         }
+        largestHoles[node] = value;
     }
+}
 
-    std::string binSize = std::bitset<8>(sizeMap).to_string();
-    binaryVec.insert(binaryVec.begin(), binSize.substr(4));
-    binaryVec.insert(binaryVec.begin() + 1, binSize.substr(0, 4));
-    uint8_t *list = new uint8_t[binaryVec.size()];                      // Allocates 'new' array of 8-bit integers
-
-    // for each item in binaryVec convert it to an unsigned long int and store it in list
-    for (int i = 0; i < binaryVec.size(); i++)
+// Largest hole, if it has at least sizeInWords words
+int64_t HoleIndex::findWorstFit(size_t sizeInWords) const
+{
+    if (holesBySize.empty() || holesBySize.rbegin()->first < sizeInWords)
     {
-        list[i] = (uint8_t)std::bitset<8>(binaryVec[i]).to_ullong();
+        return -1;
     }
-    return list;
+    return (int64_t)holesBySize.lower_bound({holesBySize.rbegin()->first, 0})->second;
 }
 
-/* GET WORD SIZE:
-Returns word size used for alignment
+
+/*--------------------------------------------|
+|      MemoryManager Class Definitions        |
+|--------------------------------------------*/
+
+/* CONTSTRUCTOR:
+Sets naive word size (in bytes, for alignment) and default allocator for finding a memory hole
 */
-unsigned MemoryManager::getWordSize()
+MemoryManager::MemoryManager(unsigned wordSize, std::function<int(int, void *)> allocator) 
 {
-    return wordSize;
+    setAllocator(allocator);            // algorithm type used
+    this->wordSize = wordSize;          // # of words
 }
 
-/* GET MEMORY START:
-Returns the byte-wise memory address of the beginning of the memory block
+/* CONTSTRUCTOR:
+Same as above, but with a fit strategy that reads the live hole index instead of a getList() copy
 */
-void *MemoryManager::getMemoryStart()
+MemoryManager::MemoryManager(unsigned wordSize, FitStrategy strategy)
 {
-    return start;
+    this->fitStrategy = strategy;       // strategy used
+    this->wordSize = wordSize;          // # of words
 }
 
-/* GET MEMORY LIMIT:
-Returns the byte limit of the current memory block
+/* CONTSTRUCTOR:
+Same as above, but with an allocator reading Wide64 hole lists
 */
-unsigned MemoryManager::getMemoryLimit()
+MemoryManager::MemoryManager(unsigned wordSize, WideAllocator allocator)
 {
-    return memLimit;
+    this->wideAlgorithmType = allocator;    // algorithm type used
+    this->wordSize = wordSize;              // # of words
+}
+
+/* DESTRUCTOR:
+Releases all memory allocated by this object WITHOUT LEAKING MEMORY!!
+*/
+MemoryManager::~MemoryManager()
+{
+    // Call the release (shutdown) function to empty the vectors representing the currently allocated memory
+    shutdown();
+}
+
+/* INITIALIZER:
+Instantiates a block of requested size from the backing store, cleans up previous block if applicable
+*/
+void MemoryManager::initialize(size_t sizeInWords)
+{
+    initialize(sizeInWords, EngineType::HoleList);
+}
+
+/* INITIALIZER:
+Same as above, with blocks placed by the given engine (the allocator function is only used by EngineType::HoleList)
+Leaves no memory block if sizeInWords words do not fit in a size_t byte count
+*/
+void MemoryManager::initialize(size_t sizeInWords, EngineType engineType)
+{
+    shutdown();                                               // clean up previous block, if any
+
+    // TLSF tags hold sizes of at most TlsfEngine::maxWords words
+    if (engineType == EngineType::Tlsf && sizeInWords > TlsfEngine::maxWords)
+    {
+        return;
+    }
+
+    // wordSize * sizeInWords must not wrap around, or a far smaller block would be acquired
+    if (sizeInWords > SIZE_MAX / wordSize)
+    {
+        return;
+    }
+
+    // Initially, check requirement that a block of at least one word is requested & the backing store can provide it
+    if (sizeInWords > 0 && memoryBlock.acquire(wordSize * sizeInWords, backingStore))
+    {
+        memWords = sizeInWords;
+        memLimit = wordSize * sizeInWords;                    // calculate memory limit (# of bytes available) by multiplying # of words & bytes per word
+        start = memoryBlock.data();                           // set start to be the address of first byte in memoryBlock
+        holes.getOccupancy().reset(sizeInWords);              // every word starts out free
+        this->engineType = engineType;
+        resetPurgedPages(true);                               // no page of a fresh mapping has been touched yet
+
+        // Engines keep their own free blocks, the hole list stays empty
+        if (engineType == EngineType::Buddy)
+        {
+            engine.reset(new BuddyEngine(sizeInWords));
+            return;
+        }
+        if (engineType == EngineType::Tlsf)
+        {
+            engine.reset(new TlsfEngine(start, wordSize, sizeInWords));
+            return;
+        }
+
+        firstNode = newNode(0, sizeInWords, true);            // the list starts as one node with start(0), blockSize(sizeInWords) & isHole(true)
+        indexToNodeMap[0] = firstNode;                        // initialize mapping to the first node
+        holes.insert(0, sizeInWords);                         // the whole block starts out as a single hole
+        if (hardened)
+        {
+            poisonWords(0, sizeInWords);
+        }
+    }
+}
+
+/* RELEASER:
+Releases memory block acquired during initialization, if any. Does this WITHOUT LEAKING MEMORY
+*/
+void MemoryManager::shutdown()
+{
+    // Empty the respective containers representing the memoryBlock, the list of nodes, and the map of nodes to locations in memory
+    firstNode = nullptr;
+    nodePool.clear();
+    spareNodes.clear();
+    if (hardened && start != nullptr)
+    {
+        exposeBytes(start, memLimit);                         // the backing store may hand the bytes to someone else
+    }
+    memoryBlock.release();
+    start = nullptr;
+    memWords = 0;
+    memLimit = 0;
+    indexToNodeMap.clear();
+    holes.clear();
+    engine.reset();
+    engineType = EngineType::HoleList;
+    handleOffsets.clear();
+    spareHandles.clear();
+    compactCursor = 0;
+    regions.clear();
+    recordedBlocks.clear();
+    stats.clear();
+    sampler.clear();
+    dirtyHoles.clear();
+    purgedPages.clear();
+    persistentArena.close();
+    rootOffset = SIZE_MAX;
+    guardedBlocks.clear();
+    quarantine.clear();
+    quarantinedWords = 0;
+}
+
+/* ALLOCATOR:
+Allocates a memory using the allocator function; If no memory available or invalid size, returns nullptr
+*/
+void *MemoryManager::allocate(size_t sizeInBytes)
+{
+    return allocateFrom(sizeInBytes, __builtin_return_address(0));
+}
+
+// Helper allocate function: allocate, for the code whose call returns to caller (where the stack of a sample starts)
+void *MemoryManager::allocateFrom(size_t sizeInBytes, const void *caller)
+{
+    size_t sizeInWords = wordsFor(sizeInBytes);                         // Gets the sizeInWords from dividing sizeInBytes by length of words (rounding up)
+
+    // Return nullptr, if nothing was requested
+    if (sizeInWords == 0)
+    {
+        return nullptr;
+    }
+
+    uint64_t began = stats.startTiming();
+
+    // While a region is active, blocks are bumped out of it or recorded for popRegion
+    void *address = regions.empty() ? allocateWords(sizeInWords) : allocateInRegion(sizeInWords);
+    return finishAllocate(address, sizeInWords, sizeInBytes, began, caller);
+}
+
+// Helper allocate function: clock reading to pass to finishAllocate (0 unless this call is one to time)
+uint64_t MemoryManager::startTiming()
+{
+    return stats.startTiming();
+}
+
+// Helper allocate function: counts an allocate call (timed if began is not 0) & samples it if its turn has come (its stack starting at caller), returns address
+void *MemoryManager::finishAllocate(void *address, size_t sizeInWords, size_t sizeInBytes, uint64_t began, const void *caller)
+{
+    if (hardened && address != nullptr)
+    {
+        armBlock(address, sizeInBytes);
+    }
+    stats.recordAllocation(sizeInWords, address != nullptr);
+    if (began != 0)
+    {
+        stats.recordAllocateLatency(AllocatorStats::now() - began);
+    }
+
+    // The only sampling cost on the common path (the countdown stays far from 0 while sampling is off)
+    bytesUntilSample -= sizeInBytes;
+    if (bytesUntilSample < 0)
+    {
+        sampleAllocation(address, sizeInBytes, caller);
+    }
+    return address;
+}
+
+/* HINTED ALLOCATOR:
+Allocates a block placed by its hint (see AllocationHint); If no memory available or invalid size, returns nullptr
+Hot & Cold are placed as by allocate while an engine or an active region places blocks
+*/
+void *MemoryManager::allocate(size_t sizeInBytes, AllocationHint hint)
+{
+    // Whole cache lines of its own, the words before it stay a hole as with any aligned block
+    if (hint == AllocationHint::Isolated)
+    {
+        if (sizeInBytes > SIZE_MAX - cacheLineSize)
+        {
+            return nullptr;
+        }
+        return allocateAlignedFrom((sizeInBytes + cacheLineSize - 1) & ~(cacheLineSize - 1), cacheLineSize, __builtin_return_address(0));
+    }
+
+    size_t sizeInWords = wordsFor(sizeInBytes);
+    if (sizeInWords == 0)
+    {
+        return nullptr;
+    }
+
+    uint64_t began = stats.startTiming();
+    void *address;
+    if (hint == AllocationHint::Default || engine || !regions.empty())
+    {
+        address = regions.empty() ? allocateWords(sizeInWords) : allocateInRegion(sizeInWords);
+    }
+    else
+    {
+        address = allocateHinted(sizeInWords, hint);
+    }
+    return finishAllocate(address, sizeInWords, sizeInBytes, began, __builtin_return_address(0));
+}
+
+// Helper allocate function: places a Hot block at the lowest free run or a Cold block at the top of the highest hole that fits (hole list only)
+void *MemoryManager::allocateHinted(size_t sizeInWords, AllocationHint hint)
+{
+    int64_t offset;
+    if (hint == AllocationHint::Hot)
+    {
+        offset = bitmapFirstFit(sizeInWords, holes);
+    }
+    else
+    {
+        holes.indexLastFit();                                          // O(log n) lookups from the first Cold block on
+        offset = holes.findLastFit(sizeInWords);
+        if (offset != -1)
+        {
+            offset += indexToNodeMap[offset]->size - sizeInWords;     // top end of the hole, the words below it stay a hole
+        }
+    }
+
+    listNode *node = claimHole(offset, sizeInWords);
+    return node ? (void *)(start + node->headIndex * wordSize) : nullptr;
+}
+
+/* ALIGNED ALLOCATOR:
+Allocates a block whose address is a multiple of alignment (a power of two); returns nullptr if no memory available, invalid size or alignment
+The block starts at the first suitable word of a hole with room for it, the words before it stay a hole (nothing is over-allocated)
+Blocks keep their alignment until reallocate moves them
+*/
+void *MemoryManager::allocateAligned(size_t sizeInBytes, size_t alignment)
+{
+    return allocateAlignedFrom(sizeInBytes, alignment, __builtin_return_address(0));
+}
+
+// Helper allocate function: allocateAligned, for the code whose call returns to caller (where the stack of a sample starts)
+void *MemoryManager::allocateAlignedFrom(size_t sizeInBytes, size_t alignment, const void *caller)
+{
+    size_t sizeInWords = wordsFor(sizeInBytes);
+    size_t alignInWords, phase;
+    if (sizeInWords == 0 || start == nullptr || !alignmentPhase(alignment, alignInWords, phase))
+    {
+        return nullptr;
+    }
+
+    uint64_t began = stats.startTiming();
+    void *address;
+
+    // Every word is suitably aligned, the block is placed as by allocate
+    if (alignInWords == 1)
+    {
+        address = regions.empty() ? allocateWords(sizeInWords) : allocateInRegion(sizeInWords);
+    }
+    else
+    {
+        // Placed as usual while a region is active, so it is recorded for popRegion
+        address = allocateAlignedWords(sizeInWords, alignInWords, phase);
+        if (address != nullptr && !regions.empty())
+        {
+            recordInRegion(address);
+        }
+    }
+    return finishAllocate(address, sizeInWords, sizeInBytes, began, caller);
+}
+
+// Helper allocate function: places a block of sizeInWords words at an offset % alignInWords == phase with the engine or hole list (regions aside)
+void *MemoryManager::allocateAlignedWords(size_t sizeInWords, size_t alignInWords, size_t phase)
+{
+    if (engine)
+    {
+        int64_t offset = engine->allocateAligned(sizeInWords, alignInWords, phase);
+        if (offset == -1)
+        {
+            return nullptr;
+        }
+        markUsed(offset, engine->blockSize(offset));
+        return (void *)(start + offset * wordSize);
+    }
+
+    // A block larger than memory never fits (and the slack below could wrap around)
+    if (sizeInWords > memWords)
+    {
+        return nullptr;
+    }
+
+    // A hole with room for the request & alignInWords - 1 words of slack always holds an aligned block
+    listNode *node = nullptr;
+    int64_t availableHole = findHole(sizeInWords + alignInWords - 1);
+    if (availableHole != -1)
+    {
+        node = claimHole(availableHole + ((phase - availableHole) & (alignInWords - 1)), sizeInWords);
+    }
+
+    // Otherwise a smaller hole may still have an aligned word early enough
+    for (auto hole = holes.begin(); node == nullptr && hole != holes.end(); ++hole)
+    {
+        size_t aligned = hole->first + ((phase - hole->first) & (alignInWords - 1));
+        if (aligned + sizeInWords <= hole->first + hole->second)
+        {
+            node = claimHole(aligned, sizeInWords);
+        }
+    }
+    return node ? (void *)(start + node->headIndex * wordSize) : nullptr;
+}
+
+// Helper allocate function: finds the word offsets whose addresses are multiples of alignment, offset % alignInWords == phase; returns false if there are none
+bool MemoryManager::alignmentPhase(size_t alignment, size_t &alignInWords, size_t &phase)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return false;
+    }
+
+    // Moving one word changes the address by wordSize, so the pattern repeats every alignment / gcd(wordSize, alignment) words
+    size_t common = std::min<size_t>(alignment, (size_t)1 << __builtin_ctzll(wordSize));
+    if ((uintptr_t)start % common != 0)
+    {
+        return false;
+    }
+
+    alignInWords = alignment / common;
+    for (phase = 0; phase < alignInWords; phase++)
+    {
+        if (((uintptr_t)start + phase * wordSize) % alignment == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* WORDS FOR:
+Returns the words a block of sizeInBytes takes, the canary included in hardened builds (0 if nothing was asked for, or if rounding up would wrap around)
+*/
+size_t MemoryManager::wordsFor(size_t sizeInBytes)
+{
+    if (sizeInBytes == 0 || sizeInBytes > SIZE_MAX - guardBytes - (wordSize - 1))
+    {
+        return 0;
+    }
+    return (sizeInBytes + guardBytes + wordSize - 1) / wordSize;
+}
+
+// Helper allocate function: records a block the countdown fell on & starts the next countdown
+void MemoryManager::sampleAllocation(void *address, size_t sizeInBytes, const void *caller)
+{
+    if (address != nullptr && sampler.getInterval() != 0)
+    {
+        sampler.record(address, sizeInBytes, caller);
+    }
+    bytesUntilSample = sampler.nextCountdown();
+}
+
+// Helper allocate function: places a block of sizeInWords words with the engine or hole list (regions aside)
+void *MemoryManager::allocateWords(size_t sizeInWords)
+{
+    if (engine)
+    {
+        int64_t offset = engine->allocate(sizeInWords);
+        if (offset == -1)
+        {
+            return nullptr;
+        }
+        markUsed(offset, engine->blockSize(offset));   // the whole block is used, even words past the request
+        return (void *)(start + offset * wordSize);
+    }
+
+    listNode *node = claimHole(findHole(sizeInWords), sizeInWords);
+
+    // Return nullptr, if failed to find availableHole or invalid size
+    if (node == nullptr)
+    {
+        return nullptr;
+    }
+    return (void *)(start + node->headIndex * wordSize);                // Return pointer to allocated memoryBlock (offsets are in words, addresses in bytes)
+}
+
+/* BATCH ALLOCATOR:
+Allocates one block per entry of sizesInBytes into out (nullptr for zero sizes or entries that did not fit); returns the number of blocks allocated
+The combined extent is looked up with a single hole search and carved into consecutive blocks, falling back to one search per entry if it does not fit
+*/
+size_t MemoryManager::allocateBatch(const std::vector<size_t> &sizesInBytes, std::vector<void *> &out)
+{
+    out.assign(sizesInBytes.size(), nullptr);
+    const void *caller = __builtin_return_address(0);
+
+    size_t totalWords = 0;
+    bool fitsOneHole = true;
+    for (size_t sizeInBytes : sizesInBytes)
+    {
+        size_t sizeInWords = wordsFor(sizeInBytes);
+        fitsOneHole = fitsOneHole && sizeInWords <= memWords && totalWords <= memWords - sizeInWords;
+        totalWords += sizeInWords;
+    }
+    if (totalWords == 0)
+    {
+        return 0;
+    }
+
+    uint64_t began = stats.startTiming();                               // one timing sample covers the whole batch
+    listNode *node = (engine || !regions.empty() || !fitsOneHole) ? nullptr : claimHole(findHole(totalWords), totalWords);
+
+    // No hole holds the whole batch (or an engine / region places blocks), place each entry on its own (each allocate is counted & timed itself)
+    if (node == nullptr)
+    {
+        size_t allocated = 0;
+        for (size_t i = 0; i < sizesInBytes.size(); i++)
+        {
+            out[i] = allocateFrom(sizesInBytes[i], caller);
+            allocated += out[i] != nullptr;
+        }
+        return allocated;
+    }
+
+    // Cut the claimed extent into one block per entry (occupancy & hole index are already up to date), each counted & sampled as by allocate
+    size_t allocated = 0;
+    for (size_t i = 0; i < sizesInBytes.size(); i++)
+    {
+        size_t sizeInWords = wordsFor(sizesInBytes[i]);
+        if (sizeInWords == 0)
+        {
+            continue;
+        }
+        if (node->size != sizeInWords)
+        {
+            splitBlock(node, sizeInWords);
+        }
+        out[i] = finishAllocate((void *)(start + node->headIndex * wordSize), sizeInWords, sizesInBytes[i], 0, caller);
+        allocated++;
+        node = node->next;
+    }
+    if (began != 0)
+    {
+        stats.recordAllocateLatency(AllocatorStats::now() - began);
+    }
+    return allocated;
+}
+
+// Helper allocate function: asks the current allocator for the offset of a hole holding sizeInWords (-1 if none)
+int64_t MemoryManager::findHole(size_t sizeInWords)
+{
+    int64_t availableHole = -1;
+
+    if (fitStrategy)
+    {
+        availableHole = fitStrategy(sizeInWords, holes);                // Fit strategy reads the live hole index directly, nothing is copied
+    }
+    else if (wideAlgorithmType && firstNode)
+    {
+        availableHole = wideAlgorithmType(sizeInWords, getWideView());   // Cached Wide64 list, only rebuilt if the holes changed since the last call
+    }
+    else if (algorithmType && firstNode)
+    {
+        // Same list as getList(), minus free words inside sub-allocator blocks (those can't be allocated here)
+        if (getHoleListFormat() == HoleListFormat::Wide64)
+        {
+            availableHole = algorithmType(sizeInWords, const_cast<uint64_t *>(getWideView()));    // Uses specified algorithm to find a hole in memory suitable for allocation
+        }
+        else
+        {
+            availableHole = algorithmType(sizeInWords, const_cast<uint16_t *>(getNarrowView()));
+        }
+    }
+
+    // Hardened builds empty the quarantine before giving up
+    if (hardened && availableHole == -1 && !quarantine.empty())
+    {
+        releaseQuarantined(0);
+        return findHole(sizeInWords);
+    }
+    return availableHole;
+}
+
+// Helper allocate function: turns sizeInWords words at availableHole into an allocated node; returns nullptr if they are not inside one hole
+listNode *MemoryManager::claimHole(int64_t availableHole, size_t sizeInWords)
+{
+    if (availableHole == -1)
+    {
+        return nullptr;
+    }
+
+    // Find the hole the allocator picked, which may start before availableHole
+    auto found = indexToNodeMap.find(availableHole);
+    if (found == indexToNodeMap.end())
+    {
+        int64_t holeStart = holes.findContaining(availableHole);
+        if (holeStart == -1)
+        {
+            return nullptr;
+        }
+        found = indexToNodeMap.find(holeStart);
+    }
+
+    listNode *node = found->second;
+
+    // Return nullptr, if the allocator picked something that is not a hole large enough for the request
+    if (!node->isHole || node->headIndex + node->size < availableHole + sizeInWords)
+    {
+        return nullptr;
+    }
+
+    // Words of the hole before availableHole stay a hole of their own
+    if (node->headIndex != (size_t)availableHole)
+    {
+        node = splitHoleAt(node, availableHole);
+    }
+
+    // if there is more space, allocate and split listNode
+    if (node->size != sizeInWords)
+    {
+        splitNode(node, sizeInWords);
+    }
+    else
+    {
+        node->isHole = false;
+        holes.erase(availableHole);
+        markUsed(availableHole, sizeInWords);
+    }
+    if (hardened)
+    {
+        checkPoison(availableHole, sizeInWords);
+    }
+    if (BitmapNextFit *nextFit = fitStrategy.target<BitmapNextFit>())
+    {
+        nextFit->claimed(availableHole, sizeInWords);                   // next fit resumes after the block actually handed out
+    }
+    return node;
+}
+
+// Helper allocate function: splits a hole node, the front sizeInWords become the allocated block & the rest becomes a new hole node after it (O(1) relinking)
+void MemoryManager::splitNode(listNode *node, size_t sizeInWords)
+{
+    // Create listNode representing the remaining hole and link it in right after the allocated block
+    listNode *remainder = newNode(node->headIndex + sizeInWords, node->size - sizeInWords, true);
+    remainder->prev = node;
+    remainder->next = node->next;
+    if (node->next)
+    {
+        node->next->prev = remainder;
+    }
+    node->next = remainder;
+
+    // Update the allocated node
+    node->size = sizeInWords;
+    node->isHole = false;
+
+    // Update map
+    indexToNodeMap[remainder->headIndex] = remainder;
+
+    // Move the hole in the hole index past the allocated block
+    holes.erase(node->headIndex);
+    holes.insert(remainder->headIndex, remainder->size);
+    markUsed(node->headIndex, sizeInWords);
+    stats.recordSplit();
+}
+
+// Helper allocate function: splits a hole node at offset, the words before offset stay in node & the returned new hole node starts at offset
+listNode *MemoryManager::splitHoleAt(listNode *node, size_t offset)
+{
+    listNode *rest = newNode(offset, node->headIndex + node->size - offset, true);
+    rest->prev = node;
+    rest->next = node->next;
+    if (node->next)
+    {
+        node->next->prev = rest;
+    }
+    node->next = rest;
+    node->size = offset - node->headIndex;
+
+    indexToNodeMap[offset] = rest;
+    holes.insert(node->headIndex, node->size);
+    holes.insert(rest->headIndex, rest->size);
+    stats.recordSplit();
+    return rest;
+}
+
+// Helper batch allocate function: splits an allocated node, the front sizeInWords stay in node & the rest becomes a new allocated node after it
+void MemoryManager::splitBlock(listNode *node, size_t sizeInWords)
+{
+    listNode *rest = newNode(node->headIndex + sizeInWords, node->size - sizeInWords, false);
+    rest->prev = node;
+    rest->next = node->next;
+    if (node->next)
+    {
+        node->next->prev = rest;
+    }
+    node->next = rest;
+    node->size = sizeInWords;
+
+    indexToNodeMap[rest->headIndex] = rest;
+    stats.recordSplit();
+}
+
+/* DEALLOCATOR:
+Frees the memory block within the memory manager so it can be reused
+*/
+void MemoryManager::free(void *address)
+{
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+
+    // If address is not a word inside the memory block, return
+    if (start == nullptr || byteAddress < start || byteAddress >= start + memLimit || (byteAddress - start) % wordSize != 0)
+    {
+        return;
+    }
+
+    // Find node and make it a hole
+    size_t wordPosition = (byteAddress - start) / wordSize;
+
+    // Blocks bumped out of a region are only freed by popRegion
+    if (inRegion(wordPosition))
+    {
+        return;
+    }
+    if (!regions.empty())
+    {
+        forgetRecorded(wordPosition);
+    }
+    if (sampler.count() != 0)
+    {
+        sampler.forget(address);
+    }
+
+    uint64_t began = stats.startTiming();
+    if (engine)
+    {
+        if (hardened && checkBlock(wordPosition, "double free"))
+        {
+            guardedBlocks.erase(wordPosition);
+        }
+        size_t released = engine->free(wordPosition);
+        if (released != 0)
+        {
+            markFree(wordPosition, released);
+            stats.recordFree();
+            if (began != 0)
+            {
+                stats.recordFreeLatency(AllocatorStats::now() - began);
+            }
+        }
+        return;
+    }
+
+    // If no associated block (or it is already a hole), return
+    auto found = indexToNodeMap.find(wordPosition);
+    if (found == indexToNodeMap.end() || found->second->isHole)
+    {
+        return;
+    }
+
+    listNode *node = found->second;
+    releaseHandle(node);
+
+    // Hardened builds hold the block back in the quarantine, its oldest blocks become holes instead
+    if (!hardened)
+    {
+        freeNode(node);
+    }
+    else if (!quarantineBlock(node))
+    {
+        return;
+    }
+
+    stats.recordFree();
+    if (began != 0)
+    {
+        stats.recordFreeLatency(AllocatorStats::now() - began);
+    }
+}
+
+// Helper deallocate function: turns an allocated node into a hole, merged with the holes around it
+void MemoryManager::freeNode(listNode *node)
+{
+    node->isHole = true;
+    markFree(node->headIndex, node->size);
+
+    // combine holes if necessary
+    mergeHoles(node);
+
+    // Holes that have stayed free long enough release their pages
+    if (!dirtyHoles.empty())
+    {
+        purgePages();
+    }
+}
+
+/* BATCH DEALLOCATOR:
+Frees every block in addresses (invalid, duplicate or already freed addresses are ignored)
+Blocks are freed in address order & coalesced in one sweep, so each resulting hole is written to the hole index once
+*/
+void MemoryManager::freeBatch(const std::vector<void *> &addresses)
+{
+    if (engine)
+    {
+        for (void *address : addresses)
+        {
+            free(address);
+        }
+        return;
+    }
+
+    // Hardened builds send each block through the quarantine (duplicates only once)
+    if (hardened)
+    {
+        std::vector<void *> unique(addresses);
+        std::sort(unique.begin(), unique.end());
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+        for (void *address : unique)
+        {
+            free(address);
+        }
+        return;
+    }
+
+    std::vector<listNode *> nodes;
+    nodes.reserve(addresses.size());
+
+    for (void *address : addresses)
+    {
+        uint8_t *byteAddress = static_cast<uint8_t *>(address);
+        if (start == nullptr || byteAddress < start || byteAddress >= start + memLimit || (byteAddress - start) % wordSize != 0)
+        {
+            continue;
+        }
+
+        size_t wordPosition = (byteAddress - start) / wordSize;
+        auto found = indexToNodeMap.find(wordPosition);
+        if (found != indexToNodeMap.end() && !found->second->isHole && !inRegion(wordPosition))
+        {
+            nodes.push_back(found->second);
+            if (!regions.empty())
+            {
+                forgetRecorded(wordPosition);
+            }
+            if (sampler.count() != 0)
+            {
+                sampler.forget(address);
+            }
+        }
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const listNode *a, const listNode *b) { return a->headIndex < b->headIndex; });
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    // Blocks later in the batch are still marked allocated while earlier ones merge, so a merge never swallows a node still to be visited
+    std::vector<listNode *> merged;
+    for (listNode *node : nodes)
+    {
+        releaseHandle(node);
+        node->isHole = true;
+        markFree(node->headIndex, node->size);
+        stats.recordFree();
+
+        listNode *prev = node->prev;
+        listNode *next = node->next;
+
+        if (prev && prev->isHole)
+        {
+            // Either a hole from before the batch (drop its stale entry) or the hole built so far in this sweep
+            if (merged.empty() || merged.back() != prev)
+            {
+                holes.erase(prev->headIndex);
+            }
+            prev->size += node->size;
+            unlinkNode(node);
+            node = prev;
+            stats.recordMerge();
+        }
+        if (next && next->isHole)
+        {
+            // Only holes from before the batch can follow, the rest of the batch is not freed yet
+            holes.erase(next->headIndex);
+            node->size += next->size;
+            unlinkNode(next);
+            stats.recordMerge();
+        }
+
+        if (merged.empty() || merged.back() != node)
+        {
+            merged.push_back(node);
+        }
+    }
+
+    // Record each resulting hole once
+    for (listNode *node : merged)
+    {
+        holes.insert(node->headIndex, node->size);
+        if (purgeThreshold != 0 && node->size >= purgeThreshold)
+        {
+            queueDirtyHole(node->headIndex, node->size);
+        }
+    }
+    if (!dirtyHoles.empty())
+    {
+        purgePages();
+    }
+}
+
+/* REALLOCATOR:
+Resizes the block at address to newSizeInBytes, keeping its contents (up to the smaller size); returns the block's new address
+Shrinking splits the tail off as a hole & growing takes words from the hole right after the block, the block is copied only if that hole is too small
+Returns nullptr (leaving the block as it was) if no memory available, if address is not a block, or for blocks bumped out of a region
+nullptr address allocates, a zero size frees
+*/
+void *MemoryManager::reallocate(void *address, size_t newSizeInBytes)
+{
+    if (address == nullptr)
+    {
+        return allocateFrom(newSizeInBytes, __builtin_return_address(0));
+    }
+    if (newSizeInBytes == 0)
+    {
+        free(address);
+        return nullptr;
+    }
+
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+    if (start == nullptr || byteAddress < start || byteAddress >= start + memLimit || (byteAddress - start) % wordSize != 0)
+    {
+        return nullptr;
+    }
+
+    size_t wordPosition = (byteAddress - start) / wordSize;
+    size_t newSizeInWords = wordsFor(newSizeInBytes);
+    if (newSizeInWords == 0 || inRegion(wordPosition))
+    {
+        return nullptr;
+    }
+    if (hardened && !checkBlock(wordPosition, "reallocate of freed block"))
+    {
+        return nullptr;
+    }
+
+    size_t oldSizeInWords;
+    if (engine)
+    {
+        // Engine blocks are resized by copying, unless the block already has room
+        oldSizeInWords = engine->blockSize(wordPosition);
+        if (oldSizeInWords == 0)
+        {
+            return nullptr;
+        }
+        if (newSizeInWords <= oldSizeInWords)
+        {
+            if (hardened)
+            {
+                armBlock(address, newSizeInBytes);
+            }
+            return address;
+        }
+    }
+    else
+    {
+        auto found = indexToNodeMap.find(wordPosition);
+        if (found == indexToNodeMap.end() || found->second->isHole)
+        {
+            return nullptr;
+        }
+
+        listNode *node = found->second;
+        oldSizeInWords = node->size;
+
+        if (newSizeInWords < node->size)
+        {
+            // The tail becomes a hole of its own (merging with a hole after it)
+            splitBlock(node, newSizeInWords);
+            listNode *tail = node->next;
+            tail->isHole = true;
+            markFree(tail->headIndex, tail->size);
+            mergeHoles(tail);
+            if (hardened)
+            {
+                armBlock(address, newSizeInBytes);
+            }
+            return address;
+        }
+        if (growInPlace(node, newSizeInWords))
+        {
+            if (hardened)
+            {
+                armBlock(address, newSizeInBytes);
+            }
+            return address;
+        }
+    }
+
+    // Copy into a new block, which takes over the old block's handle / region
+    void *newAddress = allocateWords(newSizeInWords);
+    stats.recordAllocation(newSizeInWords, newAddress != nullptr);
+    if (newAddress == nullptr)
+    {
+        return nullptr;
+    }
+    memcpy(newAddress, address, oldSizeInWords * wordSize);
+    if (hardened)
+    {
+        armBlock(newAddress, newSizeInBytes);
+    }
+
+    size_t newWordPosition = ((uint8_t *)newAddress - start) / wordSize;
+    if (!engine && indexToNodeMap[wordPosition]->handle != SIZE_MAX)
+    {
+        listNode *oldNode = indexToNodeMap[wordPosition];
+        listNode *movedNode = indexToNodeMap[newWordPosition];
+        movedNode->handle = oldNode->handle;
+        oldNode->handle = SIZE_MAX;
+        handleOffsets[movedNode->handle] = newWordPosition;
+    }
+    auto recorded = recordedBlocks.find(wordPosition);
+    if (recorded != recordedBlocks.end())
+    {
+        std::pair<size_t, size_t> slot = recorded->second;
+        recordedBlocks.erase(recorded);
+        regions[slot.first].overflow[slot.second] = newAddress;
+        recordedBlocks[newWordPosition] = slot;
+    }
+    if (sampler.count() != 0)
+    {
+        sampler.move(address, newAddress);
+    }
+
+    free(address);
+    return newAddress;
+}
+
+// Helper reallocate function: grows an allocated node to sizeInWords words out of the hole right after it, returns false if that hole is too small
+bool MemoryManager::growInPlace(listNode *node, size_t sizeInWords)
+{
+    listNode *next = node->next;
+    size_t needed = sizeInWords - node->size;
+    if (next == nullptr || !next->isHole || next->size < needed)
+    {
+        return false;
+    }
+
+    holes.erase(next->headIndex);
+    markUsed(next->headIndex, needed);
+    if (hardened)
+    {
+        checkPoison(next->headIndex, needed);
+    }
+
+    if (next->size == needed)
+    {
+        unlinkNode(next);
+    }
+    else
+    {
+        // The rest of the hole starts past the grown block
+        indexToNodeMap.erase(next->headIndex);
+        next->headIndex += needed;
+        next->size -= needed;
+        indexToNodeMap[next->headIndex] = next;
+        holes.insert(next->headIndex, next->size);
+    }
+
+    node->size = sizeInWords;
+    return true;
+}
+
+/* PUSH REGION:
+Starts a region: every block allocated until the matching popRegion is freed by it
+Up to reserveInBytes (defaultRegionReserve unless given) of those are bumped out of one block reserved now (out of the enclosing region, if it has room), the rest are placed as usual & recorded
+No block is reserved if reserveInBytes is 0 or does not fit
+Layers that keep the blocks they allocate across regions (e.g. the chunks of a SlabAllocator) take them from allocateOutsideRegion instead
+*/
+void MemoryManager::pushRegion(size_t reserveInBytes)
+{
+    if (start == nullptr)
+    {
+        return;
+    }
+
+    Region region;
+    size_t reserveInWords = wordsFor(reserveInBytes);
+    void *reserved = reserveInWords == 0 ? nullptr : allocateFrom(reserveInBytes, __builtin_return_address(0));
+    if (reserved != nullptr)
+    {
+        region.offset = ((uint8_t *)reserved - start) / wordSize;
+        region.size = reserveInWords;
+
+        // Blocks are bumped out of every word, the hardened canary included, so the reserved block is not checked
+        if (hardened)
+        {
+            guardedBlocks.erase(region.offset);
+            exposeBytes(reserved, reserveInWords * wordSize);
+        }
+        region.fromParent = !regions.empty() && regions.back().used >= reserveInWords &&
+                            regions.back().offset + regions.back().used - reserveInWords == region.offset &&
+                            inRegion(region.offset);
+    }
+    regions.push_back(std::move(region));
+}
+
+/* POP REGION:
+Frees every block allocated since the matching pushRegion, in O(1) for blocks bumped out of the region (recorded blocks are freed in one freeBatch)
+*/
+void MemoryManager::popRegion()
+{
+    if (regions.empty())
+    {
+        return;
+    }
+
+    Region region = std::move(regions.back());
+    regions.pop_back();
+
+    void *reserved = start + region.offset * wordSize;
+
+    // Blocks bumped out of the reserve are never freed one by one
+    if (sampler.count() != 0 && region.size != 0)
+    {
+        sampler.forgetRange(reserved, region.size * wordSize);
+    }
+    if (region.fromParent)
+    {
+        regions.back().used -= region.size;                           // the reserved block was the last one bumped out of the enclosing region
+    }
+    else if (region.size != 0)
+    {
+        // The enclosing region recorded the reserved block, it is freed here instead
+        forgetRecorded(region.offset);
+        region.overflow.push_back(reserved);
+    }
+
+    // The recorded blocks lie in no other region, so the other regions are set aside while they are freed (skips looking for their records)
+    for (void *address : region.overflow)
+    {
+        recordedBlocks.erase(((uint8_t *)address - start) / wordSize);
+    }
+    std::vector<Region> enclosing;
+    enclosing.swap(regions);
+    freeBatch(region.overflow);
+    regions.swap(enclosing);
+}
+
+/* ALLOCATE OUTSIDE REGION:
+Same as allocate, but the block is neither bumped out of nor recorded by the active regions, so popRegion leaves it allocated
+For sub-allocators, whose chunks hold blocks handed out before & after the region
+*/
+void *MemoryManager::allocateOutsideRegion(size_t sizeInBytes)
+{
+    // No records are made while the regions are set aside, so the record indices stay valid
+    std::vector<Region> active;
+    active.swap(regions);
+    void *address = allocateFrom(sizeInBytes, __builtin_return_address(0));
+    regions.swap(active);
+    return address;
+}
+
+/* GET REGION DEPTH:
+Returns the number of regions pushed & not yet popped
+*/
+size_t MemoryManager::getRegionDepth()
+{
+    return regions.size();
+}
+
+// Helper allocate function: bumps a block out of the innermost region, or places it as usual & records it there
+void *MemoryManager::allocateInRegion(size_t sizeInWords)
+{
+    Region &region = regions.back();
+    if (region.size - region.used >= sizeInWords)
+    {
+        size_t offset = region.offset + region.used;
+        region.used += sizeInWords;
+        return (void *)(start + offset * wordSize);
+    }
+
+    void *address = allocateWords(sizeInWords);
+    if (address != nullptr)
+    {
+        recordInRegion(address);
+    }
+    return address;
+}
+
+// Helper allocate function: records a block placed as usual in the innermost region, for popRegion to free
+void MemoryManager::recordInRegion(void *address)
+{
+    std::vector<void *> &overflow = regions.back().overflow;
+    recordedBlocks[((uint8_t *)address - start) / wordSize] = {regions.size() - 1, overflow.size()};
+    overflow.push_back(address);
+}
+
+// Helper deallocate function: drops a block freed early from the record of the region it was allocated in, in O(1) (the last record takes its place)
+void MemoryManager::forgetRecorded(size_t offset)
+{
+    auto recorded = recordedBlocks.find(offset);
+    if (recorded == recordedBlocks.end())
+    {
+        return;
+    }
+
+    std::vector<void *> &overflow = regions[recorded->second.first].overflow;
+    size_t slot = recorded->second.second;
+    recordedBlocks.erase(recorded);
+    if (slot + 1 != overflow.size())
+    {
+        overflow[slot] = overflow.back();
+        recordedBlocks[((uint8_t *)overflow[slot] - start) / wordSize].second = slot;
+    }
+    overflow.pop_back();
+}
+
+// Helper deallocate function: whether word offset lies in a region's reserved block
+bool MemoryManager::inRegion(size_t offset)
+{
+    for (const Region &region : regions)
+    {
+        if (offset >= region.offset && offset < region.offset + region.size)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* HANDLE ALLOCATOR:
+Allocates a relocatable block, returns its handle (nullHandle under the same conditions allocate returns nullptr)
+Only the hole list engine moves blocks, other engines return nullHandle
+*/
+Handle MemoryManager::allocateHandle(size_t sizeInBytes)
+{
+    if (engine)
+    {
+        return nullHandle;
+    }
+
+    // Handle blocks are never bumped out of (or freed with) a region
+    size_t sizeInWords = wordsFor(sizeInBytes);
+    if (sizeInWords == 0)
+    {
+        return nullHandle;
+    }
+    void *address = allocateWords(sizeInWords);
+    stats.recordAllocation(sizeInWords, address != nullptr);
+    if (address == nullptr)
+    {
+        return nullHandle;
+    }
+    if (hardened)
+    {
+        armBlock(address, sizeInBytes);
+    }
+
+    size_t wordPosition = ((uint8_t *)address - start) / wordSize;
+    Handle handle;
+    if (spareHandles.empty())
+    {
+        handle = handleOffsets.size();
+        handleOffsets.push_back(wordPosition);
+    }
+    else
+    {
+        handle = spareHandles.back();
+        spareHandles.pop_back();
+        handleOffsets[handle] = wordPosition;
+    }
+
+    indexToNodeMap[wordPosition]->handle = handle;
+    return handle;
+}
+
+/* RESOLVE:
+Returns the current address of a handle's block (nullptr for nullHandle or freed handles)
+The address is only valid until the next compact / compactStep
+*/
+void *MemoryManager::resolve(Handle handle)
+{
+    if (handle >= handleOffsets.size() || handleOffsets[handle] == SIZE_MAX)
+    {
+        return nullptr;
+    }
+    return start + handleOffsets[handle] * wordSize;
+}
+
+/* HANDLE DEALLOCATOR:
+Frees a handle's block, the handle may be given out again by a later allocateHandle
+*/
+void MemoryManager::freeHandle(Handle handle)
+{
+    free(resolve(handle));
+}
+
+/* COMPACT:
+Slides every relocatable block as far down as it goes, merging the holes between them
+Holes below a pinned block (from allocate) stay where they are
+*/
+void MemoryManager::compact()
+{
+    compactCursor = 0;
+    while (compactStep(SIZE_MAX))
+    {
+    }
+}
+
+/* COMPACT STEP:
+Does part of a compaction pass, moving blocks of about budgetInWords words (at least one block) between holes and the blocks after them
+Pinned blocks stepped over count against the budget like moved ones, so a step over many pinned blocks still stops after about budgetInWords words
+Resumes where the previous step stopped; returns false once the pass has reached the end (the next step starts a new pass)
+*/
+bool MemoryManager::compactStep(size_t budgetInWords)
+{
+    if (engine || start == nullptr)
+    {
+        return false;
+    }
+
+    size_t visitedWords = 0;                                  // words of the blocks moved or stepped over so far
+    while (true)
+    {
+        int64_t holeStart = holes.findNext(compactCursor);
+        listNode *hole = holeStart == -1 ? nullptr : indexToNodeMap[holeStart];
+
+        // Reached the last hole, nothing after it to move
+        if (hole == nullptr || hole->next == nullptr)
+        {
+            compactCursor = 0;
+            return false;
+        }
+
+        listNode *block = hole->next;
+        if (visitedWords > 0 && visitedWords + block->size > budgetInWords)
+        {
+            compactCursor = hole->headIndex;
+            return true;
+        }
+        visitedWords += block->size;
+
+        // Pinned blocks stay, the pass carries on with the hole after them
+        if (block->handle == SIZE_MAX)
+        {
+            compactCursor = block->headIndex + block->size;
+            continue;
+        }
+
+        slideDown(hole);
+        compactCursor = hole->headIndex + hole->size;
+    }
+}
+
+// Helper compaction function: moves the relocatable block after hole to the start of hole, the hole moves after the block (merging with the next hole)
+void MemoryManager::slideDown(listNode *hole)
+{
+    listNode *block = hole->next;
+    size_t holeStart = hole->headIndex;
+    size_t holeSize = hole->size;
+    size_t blockSize = block->size;
+    size_t blockStart = block->headIndex;
+
+    // Hardened builds check the hole & canary before moving, the canary is written again at the new offset
+    if (hardened)
+    {
+        checkPoison(holeStart, holeSize);
+        checkBlock(blockStart, "compaction of freed block");
+    }
+
+    memmove(start + holeStart * wordSize, start + blockStart * wordSize, blockSize * wordSize);
+
+    // The two nodes swap roles, so neither moves in the list
+    holes.erase(holeStart);
+    indexToNodeMap.erase(block->headIndex);
+
+    hole->isHole = false;
+    hole->size = blockSize;
+    hole->handle = block->handle;
+    handleOffsets[hole->handle] = holeStart;
+
+    block->isHole = true;
+    block->headIndex = holeStart + blockSize;
+    block->size = holeSize;
+    block->handle = SIZE_MAX;
+    indexToNodeMap[block->headIndex] = block;
+
+    // The words in use stay the same, only the bitmap changes
+    holes.getOccupancy().markFree(holeStart, holeSize + blockSize);
+    holes.getOccupancy().markUsed(holeStart, blockSize);
+    if (purgeThreshold != 0)
+    {
+        clearPurgedPages(holeStart, blockSize);
+    }
+    if (hardened)
+    {
+        auto guarded = guardedBlocks.find(blockStart);
+        if (guarded != guardedBlocks.end())
+        {
+            size_t sizeInBytes = guarded->second;
+            guardedBlocks.erase(guarded);
+            armBlock(start + holeStart * wordSize, sizeInBytes);
+        }
+        poisonWords(block->headIndex, block->size);
+    }
+
+    mergeHoles(block);
+}
+
+// Helper deallocate function: gives back the handle of a block being freed, if it has one
+void MemoryManager::releaseHandle(listNode *node)
+{
+    if (node->handle != SIZE_MAX)
+    {
+        handleOffsets[node->handle] = SIZE_MAX;
+        spareHandles.push_back(node->handle);
+        node->handle = SIZE_MAX;
+    }
+}
+
+// Helper function: marks words allocated in the occupancy bitmap & counts them as in use
+void MemoryManager::markUsed(size_t offset, size_t size)
+{
+    holes.getOccupancy().markUsed(offset, size);
+    stats.recordUsed(size * wordSize);
+    if (purgeThreshold != 0)
+    {
+        clearPurgedPages(offset, size);
+    }
+}
+
+// Helper function: marks words free in the occupancy bitmap & takes them off the bytes in use
+void MemoryManager::markFree(size_t offset, size_t size)
+{
+    holes.getOccupancy().markFree(offset, size);
+    stats.recordReleased(size * wordSize);
+    if (hardened && !engine)
+    {
+        poisonWords(offset, size);
+    }
+}
+
+// Helper function: one bit per page of the memory block, all set (nothing resident) or all clear (anything may be resident)
+void MemoryManager::resetPurgedPages(bool released)
+{
+    size_t pageSize = memoryBlock.pageSize();
+    if (purgeThreshold == 0 || pageSize == 0 || engine)
+    {
+        purgedPages.clear();
+        return;
+    }
+    size_t pageCount = memoryBlock.reservedSize() / pageSize;
+    purgedPages.assign((pageCount + 63) / 64, released ? ~uint64_t(0) : 0);
+}
+
+// Helper function: pages holding any of size words at offset are about to be touched, so they count as resident again
+void MemoryManager::clearPurgedPages(size_t offset, size_t size)
+{
+    if (purgedPages.empty() || size == 0)
+    {
+        return;
+    }
+    size_t pageSize = memoryBlock.pageSize();
+    size_t lastPage = ((offset + size) * wordSize - 1) / pageSize;
+    for (size_t page = offset * wordSize / pageSize; page <= lastPage; page++)
+    {
+        purgedPages[page / 64] &= ~(uint64_t(1) << (page % 64));
+    }
+}
+
+// Helper function: queues a large hole to have its pages released once it is purgeDecay old
+void MemoryManager::queueDirtyHole(size_t offset, size_t size)
+{
+    if (purgedPages.empty())
+    {
+        return;
+    }
+
+    // A hole that grew again since it was queued keeps one entry (with the later time)
+    if (!dirtyHoles.empty() && dirtyHoles.back().offset == offset)
+    {
+        dirtyHoles.pop_back();
+    }
+    else if (dirtyHoles.size() == maxDirtyHoles)
+    {
+        dirtyHoles.pop_front();
+    }
+    dirtyHoles.push_back({AllocatorStats::now(), offset, size});
+}
+
+// Helper function: releases the whole pages between word offsets fromWord & toWord (all free) that are not released already, returns the bytes released
+size_t MemoryManager::releaseHolePages(size_t fromWord, size_t toWord)
+{
+    size_t pageSize = memoryBlock.pageSize();
+    size_t firstPage = (fromWord * wordSize + pageSize - 1) / pageSize;
+    size_t endPage = toWord * wordSize / pageSize;
+    size_t released = 0;
+
+    size_t page = firstPage;
+    while (page < endPage)
+    {
+        // Skip pages already released, a whole bitmap word at a time where possible
+        if (page % 64 == 0 && page + 64 <= endPage && purgedPages[page / 64] == ~uint64_t(0))
+        {
+            page += 64;
+            continue;
+        }
+        if (purgedPages[page / 64] >> (page % 64) & 1)
+        {
+            page++;
+            continue;
+        }
+
+        // Release the run of pages still resident in one madvise
+        size_t runEnd = page;
+        while (runEnd < endPage && !(purgedPages[runEnd / 64] >> (runEnd % 64) & 1))
+        {
+            purgedPages[runEnd / 64] |= uint64_t(1) << (runEnd % 64);
+            runEnd++;
+        }
+        if (memoryBlock.releasePages(page * pageSize, (runEnd - page) * pageSize, lazyPurge))
+        {
+            released += (runEnd - page) * pageSize;
+            stats.recordPurge((runEnd - page) * pageSize);
+        }
+        page = runEnd;
+    }
+    return released;
+}
+
+// Helper deallocate function, merges the freed node with the hole before and/or after it in one pass
+void MemoryManager::mergeHoles(listNode *node)
+{
+    listNode *prev = node->prev;
+    listNode *next = node->next;
+
+    if (prev && prev->isHole)
+    {
+        // If prev is a hole, it absorbs the freed node
+        prev->size += node->size;
+        unlinkNode(node);
+        node = prev;
+        stats.recordMerge();
+    }
+    if (next && next->isHole)
+    {
+        // If next is a hole, the (possibly merged) node absorbs it
+        holes.erase(next->headIndex);
+        node->size += next->size;
+        unlinkNode(next);
+        stats.recordMerge();
+    }
+
+    // Record the resulting hole (replaces prev's entry if it grew)
+    holes.insert(node->headIndex, node->size);
+    if (purgeThreshold != 0 && node->size >= purgeThreshold)
+    {
+        queueDirtyHole(node->headIndex, node->size);
+    }
+}
+
+// Helper function: takes a node from the spare list (or the pool) so splits never shift other nodes around
+listNode *MemoryManager::newNode(size_t headIndex, size_t size, bool isHole)
+{
+    if (spareNodes.empty())
+    {
+        nodePool.emplace_back(headIndex, size, isHole);
+        return &nodePool.back();
+    }
+
+    listNode *node = spareNodes.back();
+    spareNodes.pop_back();
+    *node = listNode(headIndex, size, isHole);
+    return node;
+}
+
+// Helper function: removes a node that was merged away from the list & map, keeping it for reuse
+void MemoryManager::unlinkNode(listNode *node)
+{
+    if (node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        firstNode = node->next;
+    }
+    if (node->next)
+    {
+        node->next->prev = node->prev;
+    }
+
+    indexToNodeMap.erase(node->headIndex);
+    spareNodes.push_back(node);
+}
+
+/* SET ALGORTIHM TYPE:
+Changes the allocator algorithm of identifying the memory hole to use for allocation       
+bestFit and worstFit are swapped for their indexed strategies, which pick the same holes without a getList() scan
+*/
+void MemoryManager::setAllocator(std::function<int(int, void *)> allocator)
+{
+    int (*const *builtIn)(int, void *) = allocator.target<int (*)(int, void *)>();
+
+    if (builtIn && *builtIn == bestFit)
+    {
+        setAllocator(FitStrategy(indexedBestFit));
+        return;
+    }
+    if (builtIn && *builtIn == worstFit)
+    {
+        setAllocator(FitStrategy(indexedWorstFit));
+        return;
+    }
+
+    this->algorithmType = allocator;
+    this->fitStrategy = nullptr;
+    this->wideAlgorithmType = nullptr;
+}
+
+// Same as above, but for fit strategies that read the live hole index (no getList() copy per allocation)
+void MemoryManager::setAllocator(FitStrategy strategy)
+{
+    this->fitStrategy = strategy;
+    this->algorithmType = nullptr;
+    this->wideAlgorithmType = nullptr;
+}
+
+// Same as above, but for allocators that read a Wide64 hole list
+void MemoryManager::setAllocator(WideAllocator allocator)
+{
+    this->wideAlgorithmType = allocator;
+    this->fitStrategy = nullptr;
+    this->algorithmType = nullptr;
+}
+
+/* SET HOLE LIST FORMAT:
+Changes the format of lists returned by getList (and given to std::function<int(int, void*)> allocators)
+*/
+void MemoryManager::setHoleListFormat(HoleListFormat format)
+{
+    this->holeListFormat = format;
+}
+
+/* SET BACKING STORE:
+Changes where the memory block comes from (aligned heap, lazily committed mmap or huge pages), takes effect at the next initialize
+*/
+void MemoryManager::setBackingStore(BackingStore type)
+{
+    this->backingStore = type;
+}
+
+/* ATTACH / DETACH SUB-ALLOCATOR:
+Adds (or removes) a layer whose free ranges inside allocated blocks are reported as holes by getList, getBitmap & dumpMemoryMap
+*/
+void MemoryManager::attachSubAllocator(const SubAllocator *subAllocator)
+{
+    subAllocators.push_back(subAllocator);
+}
+
+void MemoryManager::detachSubAllocator(const SubAllocator *subAllocator)
+{
+    subAllocators.erase(std::remove(subAllocators.begin(), subAllocators.end(), subAllocator), subAllocators.end());
+}
+
+/* ADD HOLE LIST TO FILENAME:
+Uses standard POSIX calls to write hole list to filename AS TEXT, returns -1 on error & 0 if successful
+*/
+int MemoryManager::dumpMemoryMap(char *filename)
+{
+    // use POSIX calls to write holeList to file (truncated, so a shorter map leaves no stale bytes behind)
+    int file = open(filename, O_CREAT | O_WRONLY | O_TRUNC, 0600);
+    if (file < 0)
+    {
+        return -1;
+    }
+
+    const size_t flushBytes = 64 * 1024;
+    std::string outputStr = "";
+    bool first = true;
+    bool failed = false;
+
+    // For each hole (in offset order) add its offset & size to outputStr and surround them in brackets, writing it out every flushBytes
+    auto addHole = [&](size_t offset, size_t size) {
+        outputStr += (first ? "[" : " - [") + std::to_string(offset) + ", " + std::to_string(size) + "]";
+        first = false;
+        if (outputStr.size() >= flushBytes)
+        {
+            failed = failed || writeFully(file, outputStr.data(), outputStr.size()) == -1;
+            outputStr.clear();
+        }
+    };
+
+    if (!hasOverlay() && !engine)
+    {
+        for (auto &hole : holes)
+        {
+            addHole(hole.first, hole.second);
+        }
+    }
+    else
+    {
+        for (auto &hole : getReportedHoles())
+        {
+            addHole(hole.first, hole.second);
+        }
+    }
+
+    // Return -1, if write operation or close operation fail
+    failed = failed || writeFully(file, outputStr.data(), outputStr.size()) == -1;
+    if (close(file) == -1 || failed)
+    {
+        return -1;
+    }
+    else 
+    {
+        // Return 0, if successful
+        return 0;
+    }
+}
+
+/* DUMP MEMORY MAP BINARY:
+Writes the holes to a file in the binary memory map format (see MemoryMapDump.h), replacing its contents; returns 0 on success, -1 on error
+*/
+int MemoryManager::dumpMemoryMapBinary(char *filename)
+{
+    int file = open(filename, O_CREAT | O_WRONLY | O_TRUNC, 0600);
+    if (file < 0)
+    {
+        return -1;
+    }
+
+    int result = dumpMemoryMapBinary(file);
+    if (close(file) == -1)
+    {
+        return -1;
+    }
+    return result;
+}
+
+/* DUMP MEMORY MAP BINARY:
+Same as above, written to an open file descriptor (left open) with writev
+*/
+int MemoryManager::dumpMemoryMapBinary(int fd)
+{
+    return encodeMemoryMap().writeTo(fd);
+}
+
+/* DUMP MEMORY MAP BINARY:
+Same as above, handed to sink in pieces of up to 64KB; the map is taken before the first piece, so sink may use this manager
+*/
+int MemoryManager::dumpMemoryMapBinary(const DumpSink &sink)
+{
+    return encodeMemoryMap().sendTo(sink);
+}
+
+// Helper function: encodes the holes dumpMemoryMap reports into a binary memory map
+MemoryMapWriter MemoryManager::encodeMemoryMap()
+{
+    if (!hasOverlay() && !engine)
+    {
+        MemoryMapWriter writer(wordSize, memWords, holes.count());
+        for (auto &hole : holes)
+        {
+            writer.addHole(hole.first, hole.second);
+        }
+        return writer;
+    }
+
+    std::vector<std::pair<size_t, size_t>> reportedHoles = getReportedHoles();
+    MemoryMapWriter writer(wordSize, memWords, reportedHoles.size());
+    for (auto &hole : reportedHoles)
+    {
+        writer.addHole(hole.first, hole.second);
+    }
+    return writer;
+}
+
+/* GET LIST:
+Returns an array of information (in decimal) about holes for use by the allocator function, if no memory has been allocated, returns nullptr
+Entries are uint16_t or uint64_t depending on the hole list format (see setHoleListFormat)
+*/
+void *MemoryManager::getList()
+{
+    // Return nullptr, if there is no memory block
+    if (start == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (getHoleListFormat() == HoleListFormat::Wide64)
+    {
+        return getWideList(true);
+    }
+    return getNarrowList(true);
+}
+
+// Helper function: copies holes (already in offset order) into a 'new' list of [count, offset, size, ...] entries
+template <typename Entry, typename Holes>
+static Entry *buildHoleList(const Holes &holeRuns, size_t holeCount)
+{
+    Entry *list = new Entry[1 + (holeCount * 2)];                   // Allocate memory for 'list' which points to an array containing the holes in memory
+    Entry *entry = list;
+    *entry++ = (Entry)holeCount;
+
+    for (auto &hole : holeRuns)
+    {
+        *entry++ = (Entry)hole.first;
+        *entry++ = (Entry)hole.second;
+    }
+    return list;
+}
+
+// Helper function: builds a Narrow16 hole list, including free words of sub-allocators if reported
+uint16_t *MemoryManager::getNarrowList(bool reported)
+{
+    if (engine || (reported && hasOverlay()))
+    {
+        std::vector<std::pair<size_t, size_t>> reportedHoles = getReportedHoles();
+        return buildHoleList<uint16_t>(reportedHoles, reportedHoles.size());
+    }
+    return buildHoleList<uint16_t>(holes, holes.count());
+}
+
+// Helper function: builds a Wide64 hole list, including free words of sub-allocators if reported
+uint64_t *MemoryManager::getWideList(bool reported)
+{
+    if (engine || (reported && hasOverlay()))
+    {
+        std::vector<std::pair<size_t, size_t>> reportedHoles = getReportedHoles();
+        return buildHoleList<uint64_t>(reportedHoles, reportedHoles.size());
+    }
+    return buildHoleList<uint64_t>(holes, holes.count());
+}
+
+// Helper function: refills view with holes as a [count, offset, size, ...] list if they changed since builtAt, returns the list
+template <typename Entry>
+static const Entry *refreshHoleView(std::vector<Entry> &view, uint64_t &builtAt, const HoleIndex &holes)
+{
+    if (builtAt != holes.getGeneration())
+    {
+        view.resize(1 + holes.count() * 2);                            // keeps the buffer, nothing is allocated unless the list grows
+        Entry *entry = view.data();
+        *entry++ = (Entry)holes.count();
+        for (auto &hole : holes)
+        {
+            *entry++ = (Entry)hole.first;
+            *entry++ = (Entry)hole.second;
+        }
+        builtAt = holes.getGeneration();
+    }
+    return view.data();
+}
+
+// Helper function: the hole index as a cached Narrow16 list
+const uint16_t *MemoryManager::getNarrowView()
+{
+    return refreshHoleView(narrowView, narrowViewGeneration, holes);
+}
+
+// Helper function: the hole index as a cached Wide64 list
+const uint64_t *MemoryManager::getWideView()
+{
+    return refreshHoleView(wideView, wideViewGeneration, holes);
+}
+
+// Helper function: holes (or the engine's free blocks) plus the free ranges of every sub-allocator & region, sorted by offset with touching ranges merged
+std::vector<std::pair<size_t, size_t>> MemoryManager::getReportedHoles()
+{
+    std::vector<std::pair<size_t, size_t>> ranges(holes.begin(), holes.end());
+    if (engine)
+    {
+        engine->forEachHole([&ranges](size_t offset, size_t size) { ranges.push_back({offset, size}); });
+    }
+    forEachOverlayRange([&ranges](size_t offset, size_t size) { ranges.push_back({offset, size}); });
+    std::sort(ranges.begin(), ranges.end());
+
+    std::vector<std::pair<size_t, size_t>> merged;
+    for (auto &range : ranges)
+    {
+        if (!merged.empty() && merged.back().first + merged.back().second == range.first)
+        {
+            merged.back().second += range.second;
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+/* GET BIT MAP:
+Returns a bit-stream in terms of an array representing whether words are used (1) or free (0)
+First bytes are size of bitmap (low byte first): 2 bytes for Narrow16 hole lists, 8 bytes for Wide64 (see getHoleListFormat), rest is the bitmap copied out of the occupancy bitmap
+*/
+void *MemoryManager::getBitmap()
+{
+    const OccupancyBitmap &occupancy = holes.getOccupancy();
+    size_t sizeMap = (occupancy.size() + 8 - 1) / 8;
+    size_t lengthBytes = getHoleListFormat() == HoleListFormat::Wide64 ? 8 : 2;
+    uint8_t *list = new uint8_t[lengthBytes + sizeMap];                 // Allocates 'new' array of 8-bit integers
+
+    for (size_t i = 0; i < lengthBytes; i++)
+    {
+        list[i] = (uint8_t)((sizeMap >> (i * 8)) & 0xFF);
+    }
+    uint8_t *bitmap = list + lengthBytes;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Word i is bit i % 8 of byte i / 8, which is exactly the in-memory layout of the packed uint64_t bits
+    memcpy(bitmap, occupancy.data(), sizeMap);
+#else
+    for (size_t i = 0; i < sizeMap; i++)
+    {
+        bitmap[i] = (uint8_t)(occupancy.data()[i / 8] >> ((i % 8) * 8));
+    }
+#endif
+
+    // Free words inside sub-allocator blocks & regions show as free too
+    forEachOverlayRange([bitmap](size_t offset, size_t size) {
+        for (size_t word = offset; word < offset + size; word++)
+        {
+            bitmap[word / 8] &= (uint8_t)~(1u << (word % 8));
+        }
+    });
+    return list;
+}
+
+// Helper function: whether any free words are reported on top of the holes (sub-allocators or regions)
+bool MemoryManager::hasOverlay()
+{
+    return !subAllocators.empty() || !regions.empty();
+}
+
+// Helper function: calls visit(word offset, size in words) for the free ranges of every sub-allocator & the unused tail of every region
+void MemoryManager::forEachOverlayRange(const std::function<void(size_t offset, size_t size)> &visit)
+{
+    for (const SubAllocator *subAllocator : subAllocators)
+    {
+        subAllocator->forEachFreeRange(visit);
+    }
+    for (const Region &region : regions)
+    {
+        if (region.used < region.size)
+        {
+            visit(region.offset + region.used, region.size - region.used);
+        }
+    }
+}
+
+/* GET WORD SIZE:
+Returns word size used for alignment
+*/
+unsigned MemoryManager::getWordSize()
+{
+    return wordSize;
+}
+
+/* GET MEMORY START:
+Returns the byte-wise memory address of the beginning of the memory block
+*/
+void *MemoryManager::getMemoryStart()
+{
+    return start;
+}
+
+/* GET MEMORY LIMIT:
+Returns the byte limit of the current memory block
+*/
+size_t MemoryManager::getMemoryLimit()
+{
+    return memLimit;
+}
+
+/* IS EMPTY:
+Returns whether no block is allocated; blocks waiting in the quarantine of a hardened build count as freed
+*/
+bool MemoryManager::isEmpty()
+{
+    return stats.getBytesInUse() == quarantinedWords * wordSize;
+}
+
+/* GET BACKING STORE:
+Returns the store used for the memory block (at the next initialize, if changed since)
+*/
+BackingStore MemoryManager::getBackingStore()
+{
+    return backingStore;
+}
+
+/* GET ENGINE TYPE:
+Returns the engine placing blocks in the current memory block
+*/
+EngineType MemoryManager::getEngineType()
+{
+    return engineType;
+}
+
+/* GET HOLE LIST FORMAT:
+Returns the format getList currently produces (Auto resolved against the size of the memory block)
+*/
+HoleListFormat MemoryManager::getHoleListFormat()
+{
+    if (holeListFormat == HoleListFormat::Auto)
+    {
+        return (start && memWords > 65536) ? HoleListFormat::Wide64 : HoleListFormat::Narrow16;
+    }
+    return holeListFormat;
+}
+
+/* GET HOLE INDEX:
+Returns the live (read-only) index of holes used by fit strategies (empty while an engine places blocks)
+*/
+const HoleIndex &MemoryManager::getHoleIndex() const
+{
+    return holes;
+}
+
+/* GET HOLE LIST VIEW:
+Returns the hole list in getList's format without copying it (see HoleListView), rebuilt only if the holes changed since it was last built
+Also starts the journal read by forEachHoleChange
+*/
+HoleListView MemoryManager::getHoleListView()
+{
+    holes.trackChanges();
+    if (start == nullptr || engine)
+    {
+        return {nullptr, holes.getGeneration()};
+    }
+    if (getHoleListFormat() == HoleListFormat::Wide64)
+    {
+        return {getWideView(), holes.getGeneration()};
+    }
+    return {getNarrowView(), holes.getGeneration()};
+}
+
+/* GET HOLE GENERATION:
+Returns the number of changes made to the holes so far, equal generations mean the same holes
+*/
+uint64_t MemoryManager::getHoleGeneration() const
+{
+    return holes.getGeneration();
+}
+
+/* FOR EACH HOLE CHANGE:
+Calls visit for every change to the holes after sinceGeneration (from a HoleListView or an earlier call), oldest first
+Returns false without visiting anything if those changes are no longer all kept (the journal holds the last 4096, from the first view or call on), read the view again then
+*/
+bool MemoryManager::forEachHoleChange(uint64_t sinceGeneration, const std::function<void(const HoleChange &change)> &visit)
+{
+    holes.trackChanges();
+    return holes.forEachChange(sinceGeneration, visit);
+}
+
+/* GET STATS:
+Returns a snapshot of the counters along with the holes of the memory block (needs the same locking as getList)
+Holes are those the engine / hole list can allocate from: free words inside sub-allocator blocks & region reserves count as in use
+*/
+MemoryStats MemoryManager::getStats()
+{
+    MemoryStats snapshot;
+    stats.snapshot(snapshot);
+
+    auto visit = [this, &snapshot](size_t, size_t size) {
+        snapshot.holeCount++;
+        snapshot.freeBytes += size * wordSize;
+        snapshot.largestHole = std::max(snapshot.largestHole, size * wordSize);
+    };
+    for (auto &hole : holes)
+    {
+        visit(hole.first, hole.second);
+    }
+    if (engine)
+    {
+        engine->forEachHole(visit);
+    }
+
+    if (snapshot.freeBytes != 0)
+    {
+        snapshot.fragmentation = 1.0 - (double)snapshot.largestHole / snapshot.freeBytes;
+    }
+    return snapshot;
+}
+
+/* GET ALLOCATOR STATS:
+Returns the live counters, which any thread may read while the manager is in use
+*/
+const AllocatorStats &MemoryManager::getAllocatorStats() const
+{
+    return stats;
+}
+
+/* RESET STATS:
+Clears the counters & histograms, the peak restarts from the bytes currently in use
+*/
+void MemoryManager::resetStats()
+{
+    stats.reset();
+}
+
+/* SET LATENCY SAMPLING:
+Times one allocate / free call in everyNthCall for the latency histograms (default AllocatorStats::defaultLatencySampling, 1 times every call, 0 turns timing off)
+The counters are kept for every call whatever the setting
+*/
+void MemoryManager::setLatencySampling(unsigned everyNthCall)
+{
+    stats.setLatencySampling(everyNthCall);
+}
+
+/* SET PAGE PURGE:
+Holes of at least thresholdInBytes (0 turns purging off, the default) hand the pages inside them back to the kernel once they have stayed free for decayInMilliseconds
+Only Mmap / HugePages arenas with the hole list release pages; lazy uses MADV_FREE (pages are only dropped under memory pressure) instead of MADV_DONTNEED
+Released pages are zero-filled when next touched; does nothing in hardened builds
+*/
+void MemoryManager::setPagePurge(size_t thresholdInBytes, uint64_t decayInMilliseconds, bool lazy)
+{
+    // Released pages come back zero-filled, which hardened builds would take for writes after free
+    if (hardened)
+    {
+        return;
+    }
+
+    purgeThreshold = thresholdInBytes == 0 ? 0 : std::max<size_t>(1, (thresholdInBytes + wordSize - 1) / wordSize);
+    purgeDecay = decayInMilliseconds * 1000000;
+    lazyPurge = lazy;
+    dirtyHoles.clear();
+
+    // Which pages are resident is unknown from here on, so every free page counts as dirty
+    resetPurgedPages(false);
+    for (auto &hole : holes)
+    {
+        if (purgeThreshold != 0 && hole.second >= purgeThreshold)
+        {
+            queueDirtyHole(hole.first, hole.second);
+        }
+    }
+}
+
+/* PURGE PAGES:
+Releases the pages of large holes that have stayed free for the decay time (every large hole if ignoreDecay); returns the number of bytes released
+Called by free, call it from a timer to also release pages of a manager that has gone idle
+*/
+size_t MemoryManager::purgePages(bool ignoreDecay)
+{
+    size_t released = 0;
+    uint64_t now = AllocatorStats::now();
+
+    while (!dirtyHoles.empty() && (ignoreDecay || now - dirtyHoles.front().freedAt >= purgeDecay))
+    {
+        DirtyHole dirty = dirtyHoles.front();
+        dirtyHoles.pop_front();
+
+        // The hole may have been allocated from, merged or split since, only words of large holes still free are released
+        int64_t hole = holes.findContaining(dirty.offset);
+        if (hole == -1)
+        {
+            hole = holes.findNext(dirty.offset);
+        }
+        while (hole != -1 && (size_t)hole < dirty.offset + dirty.size)
+        {
+            size_t holeSize = indexToNodeMap[hole]->size;
+            if (holeSize >= purgeThreshold)
+            {
+                released += releaseHolePages(std::max<size_t>(hole, dirty.offset), std::min(hole + holeSize, dirty.offset + dirty.size));
+            }
+            hole = holes.findNext(hole + holeSize);
+        }
+    }
+    return released;
+}
+
+/* ATTACH:
+Uses the arena in filename as the memory block, creating one of sizeInWords words if the file is empty or missing (sizeInWords is ignored otherwise)
+Blocks allocated at the last sync are allocated again at the same offsets, with their handles & contents, everything else is free; pages are read in as they are touched
+The memory block goes at the address it had when last synced if that range is free, so addresses stored in blocks stay valid (offsets always do)
+Takes O(blocks) time: the block list of the last sync is read & checked, then each block gets its node, map entry & handle back
+Returns false (no memory block) if the file could not be opened, mapped or read, or holds an arena of another word size
+*/
+bool MemoryManager::attach(char *filename, size_t sizeInWords)
+{
+    shutdown();
+
+    std::vector<PersistentBlock> blocks;
+    uint64_t root;
+    if (!persistentArena.open(filename, wordSize, sizeInWords) || !persistentArena.load(blocks, root) ||
+        !memoryBlock.acquireFile(persistentArena.getFd(), persistentArena.getDataOffset(), persistentArena.getSizeInWords() * wordSize, persistentArena.getMappedAt()))
+    {
+        shutdown();
+        return false;
+    }
+
+    memWords = persistentArena.getSizeInWords();
+    memLimit = wordSize * memWords;
+    start = memoryBlock.data();
+    holes.getOccupancy().reset(memWords);
+    resetPurgedPages(false);                                  // pages of the file may be cached already
+
+    if (!rebuildBlocks(blocks))
+    {
+        shutdown();
+        return false;
+    }
+    if (hardened)
+    {
+        for (auto &hole : holes)
+        {
+            poisonWords(hole.first, hole.second);
+        }
+    }
+    if (root != UINT64_MAX && indexToNodeMap.count(root) != 0 && !indexToNodeMap[root]->isHole)
+    {
+        rootOffset = root;
+    }
+    return true;
+}
+
+/* SYNC:
+Makes the blocks allocated now (& the root) what the next attach picks up: flushes the memory block with msync, then saves the block list
+The block list of the previous sync stays intact until the new one is on disk, so a crash leaves one or the other
+Block contents are written through as they are stored, sync only waits for them; returns false if not attached, while a region is active, or if the file could not be written
+*/
+bool MemoryManager::sync()
+{
+    if (!persistentArena.isOpen() || !regions.empty())
+    {
+        return false;
+    }
+    if (hardened)
+    {
+        releaseQuarantined(0);                                // quarantined blocks are free, not kept
+    }
+
+    std::vector<PersistentBlock> blocks;
+    for (listNode *node = firstNode; node; node = node->next)
+    {
+        if (!node->isHole)
+        {
+            blocks.push_back({node->headIndex, node->size, node->handle == SIZE_MAX ? UINT64_MAX : (uint64_t)node->handle});
+        }
+    }
+    return memoryBlock.flush() && persistentArena.save(blocks, rootOffset == SIZE_MAX ? UINT64_MAX : rootOffset, start);
+}
+
+/* SET ROOT:
+Remembers the block at address as the root (the entry point to the data in an attached arena), kept by sync & found again with getRoot after attach
+nullptr, or an address that is not the start of an allocated block, clears the root
+*/
+void MemoryManager::setRoot(void *address)
+{
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+    rootOffset = SIZE_MAX;
+    if (start == nullptr || byteAddress < start || byteAddress >= start + memLimit || (byteAddress - start) % wordSize != 0)
+    {
+        return;
+    }
+
+    auto found = indexToNodeMap.find((byteAddress - start) / wordSize);
+    if (found != indexToNodeMap.end() && !found->second->isHole)
+    {
+        rootOffset = found->first;
+    }
+}
+
+/* GET ROOT:
+Returns the root block's address, nullptr if there is none or it has been freed
+*/
+void *MemoryManager::getRoot()
+{
+    auto found = indexToNodeMap.find(rootOffset);
+    if (found == indexToNodeMap.end() || found->second->isHole)
+    {
+        return nullptr;
+    }
+    return (void *)(start + rootOffset * wordSize);
+}
+
+// Helper function: rebuilds the node list, hole index, occupancy & handles from the blocks of a sync; false if they overlap, run past memory or are out of order
+bool MemoryManager::rebuildBlocks(const std::vector<PersistentBlock> &blocks)
+{
+    size_t end = 0;
+    for (const PersistentBlock &block : blocks)
+    {
+        if (block.offset < end || block.size == 0 || block.offset >= memWords || block.size > memWords - block.offset ||
+            (block.handle != UINT64_MAX && block.handle >= memWords))
+        {
+            return false;
+        }
+        end = block.offset + block.size;
+    }
+
+    listNode *last = nullptr;
+    auto append = [&](size_t offset, size_t size, bool isHole) {
+        listNode *node = newNode(offset, size, isHole);
+        node->prev = last;
+        (last ? last->next : firstNode) = node;
+        last = node;
+        indexToNodeMap[offset] = node;
+        if (isHole)
+        {
+            holes.insert(offset, size);
+        }
+        else
+        {
+            markUsed(offset, size);
+        }
+        return node;
+    };
+
+    // A hole goes in each gap between the blocks
+    size_t cursor = 0;
+    for (const PersistentBlock &block : blocks)
+    {
+        if (block.offset > cursor)
+        {
+            append(cursor, block.offset - cursor, true);
+        }
+        listNode *node = append(block.offset, block.size, false);
+        if (block.handle != UINT64_MAX)
+        {
+            if (handleOffsets.size() <= block.handle)
+            {
+                handleOffsets.resize(block.handle + 1, SIZE_MAX);
+            }
+            handleOffsets[block.handle] = block.offset;
+            node->handle = block.handle;
+        }
+        cursor = block.offset + block.size;
+    }
+    if (cursor < memWords)
+    {
+        append(cursor, memWords - cursor, true);
+    }
+
+    // Handles between the ones in use are free again, lowest reused first
+    for (size_t handle = handleOffsets.size(); handle-- > 0;)
+    {
+        if (handleOffsets[handle] == SIZE_MAX)
+        {
+            spareHandles.push_back(handle);
+        }
+    }
+    return true;
+}
+
+/* IS HARDENED:
+Whether the library was built with -DMEMORY_MANAGER_HARDENED (canaries, poisoned holes & the quarantine, see MemoryManager.h)
+*/
+bool MemoryManager::isHardened()
+{
+    return hardened;
+}
+
+/* SET CORRUPTION HANDLER:
+Calls handler (problem, address of the block or word) for each problem the hardened checks find, instead of printing it & aborting
+An empty handler restores the default; never called in other builds
+*/
+void MemoryManager::setCorruptionHandler(CorruptionHandler handler)
+{
+    corruptionHandler = handler;
+}
+
+/* SET QUARANTINE LIMIT:
+Sets the bytes freed blocks may take in the quarantine before the oldest become holes (SIZE_MAX, the default: 1/8 of memory)
+0 checks each freed block & turns it into a hole right away, so blocks are reused as in other builds (blocks freed twice are then ignored, not reported)
+No effect in other builds
+*/
+void MemoryManager::setQuarantineLimit(size_t bytes)
+{
+    quarantineLimit = bytes;
+    if (hardened && start != nullptr)
+    {
+        releaseQuarantined(quarantineLimitInWords());
+    }
+}
+
+// Helper hardened function: words the quarantine may hold
+size_t MemoryManager::quarantineLimitInWords()
+{
+    return quarantineLimit == SIZE_MAX ? memWords / quarantineShare : quarantineLimit / wordSize;
+}
+
+// Helper hardened function: fills the bytes from sizeInBytes to the end of the block's words with the canary & remembers the size asked for
+void MemoryManager::armBlock(void *address, size_t sizeInBytes)
+{
+    size_t offset = ((uint8_t *)address - start) / wordSize;
+    if (inRegion(offset))
+    {
+        return;                                               // bumped out of a region, popRegion frees it with the reserved block
+    }
+
+    uint8_t *bytes = static_cast<uint8_t *>(address);
+    size_t end = wordsFor(sizeInBytes) * wordSize;
+    exposeBytes(bytes, end);
+    memset(bytes + sizeInBytes, guardByte, end - sizeInBytes);
+    hideBytes(bytes + sizeInBytes, end - sizeInBytes);
+    guardedBlocks[offset] = sizeInBytes;
+}
+
+// Helper hardened function: reports a block whose canary was overwritten, leaving the canary addressable; returns false (reporting freedProblem) if the block is quarantined
+bool MemoryManager::checkBlock(size_t offset, const char *freedProblem)
+{
+    auto guarded = guardedBlocks.find(offset);
+    if (guarded == guardedBlocks.end())
+    {
+        return true;
+    }
+    if (guarded->second == SIZE_MAX)
+    {
+        reportCorruption(freedProblem, offset);
+        return false;
+    }
+
+    uint8_t *bytes = start + offset * wordSize;
+    size_t end = wordsFor(guarded->second) * wordSize;
+    exposeBytes(bytes + guarded->second, end - guarded->second);
+    for (size_t i = guarded->second; i < end; i++)
+    {
+        if (bytes[i] != guardByte)
+        {
+            reportCorruption("write past end of block", offset);
+            break;
+        }
+    }
+    return true;
+}
+
+// Helper hardened function: checks a block being freed, poisons it & holds it in the quarantine (releasing the oldest blocks past the limit); returns false if it is quarantined already
+bool MemoryManager::quarantineBlock(listNode *node)
+{
+    if (!checkBlock(node->headIndex, "double free"))
+    {
+        return false;
+    }
+
+    guardedBlocks[node->headIndex] = SIZE_MAX;
+    poisonWords(node->headIndex, node->size);
+    quarantine.push_back(node->headIndex);
+    quarantinedWords += node->size;
+    releaseQuarantined(quarantineLimitInWords());
+    return true;
+}
+
+// Helper hardened function: turns the oldest quarantined blocks into holes until at most keepWords words are left, reporting blocks written to while there
+void MemoryManager::releaseQuarantined(size_t keepWords)
+{
+    while (quarantinedWords > keepWords)
+    {
+        size_t offset = quarantine.front();
+        quarantine.pop_front();
+        listNode *node = indexToNodeMap[offset];
+        quarantinedWords -= node->size;
+        guardedBlocks.erase(offset);
+
+        checkPoison(offset, node->size);
+        freeNode(node);
+    }
+}
+
+// Helper hardened function: fills size words at offset with freedByte & marks them unaddressable
+void MemoryManager::poisonWords(size_t offset, size_t size)
+{
+    uint8_t *bytes = start + offset * wordSize;
+    memset(bytes, freedByte, size * wordSize);
+    hideBytes(bytes, size * wordSize);
+}
+
+// Helper hardened function: reports the first of size words at offset that no longer holds freedByte (stored to after being freed), leaving the words addressable
+void MemoryManager::checkPoison(size_t offset, size_t size)
+{
+    uint8_t *bytes = start + offset * wordSize;
+    exposeBytes(bytes, size * wordSize);
+    for (size_t i = 0; i < size * wordSize; i++)
+    {
+        if (bytes[i] != freedByte)
+        {
+            reportCorruption("write after free", offset + i / wordSize);
+            return;
+        }
+    }
+}
+
+// Helper hardened function: hands a problem found at word offset to the corruption handler, or prints it & aborts
+void MemoryManager::reportCorruption(const char *problem, size_t offset)
+{
+    void *address = start + offset * wordSize;
+    if (corruptionHandler)
+    {
+        corruptionHandler(problem, address);
+        return;
+    }
+    std::cerr << "MemoryManager: " << problem << " at " << address << std::endl;
+    std::abort();
+}
+
+/* SET SAMPLING INTERVAL:
+Samples about one allocation per bytes requested (0 turns sampling off, the default); sampled blocks are tracked with their call stacks until freed
+*/
+void MemoryManager::setSamplingInterval(size_t bytes)
+{
+    sampler.setInterval(bytes);
+    bytesUntilSample = sampler.nextCountdown();
+}
+
+/* GET SAMPLING INTERVAL:
+Returns the mean bytes between samples, 0 when sampling is off
+*/
+size_t MemoryManager::getSamplingInterval()
+{
+    return sampler.getInterval();
+}
+
+/* GET SAMPLED ALLOCATIONS:
+Returns the sampled blocks that are still allocated, with the stacks that allocated them
+*/
+std::vector<SampledAllocation> MemoryManager::getSampledAllocations()
+{
+    return sampler.getSamples();
+}
+
+/* DUMP HEAP PROFILE:
+Writes the sampled blocks still allocated to filename as a pprof heap profile (e.g. pprof -top program filename), replacing its contents
+Returns -1 on error & 0 if successful
+*/
+int MemoryManager::dumpHeapProfile(char *filename)
+{
+    int file = open(filename, O_CREAT | O_WRONLY | O_TRUNC, 0600);
+    if (file < 0)
+    {
+        return -1;
+    }
+
+    int result = sampler.writeProfile(file);
+    if (close(file) == -1)
+    {
+        return -1;
+    }
+    return result;
 }
@@ -7,25 +7,45 @@
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <set>
+#include <deque>
+#include <unordered_map>
 #include <bitset>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fcntl.h>
 #include <unistd.h>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "ArenaStore.h"
+#include "AllocatorEngine.h"
+#include "BitmapScan.h"
+#include "AllocatorStats.h"
+#include "MemoryMapDump.h"
+#include "AllocationSampler.h"
+#include "PersistentArena.h"
 
 /*
 |--------------------------------------------------------------------------------|
 |  Linked List Node Struct                                                       |
-|     - Contains int representing number of words, int representing headIndex    |
+|     - Contains value representing number of words, value for its headIndex     |
 |       and a bool representing if the node is a hole (isFree) or is allocated   |
+|     - Linked to its neighbours in memory order, so splits & merges are O(1)    |
 |--------------------------------------------------------------------------------|
 */
 struct listNode
 {
-        int size;                       // number of words
-        int headIndex;                  // position in memory
+        size_t size;                    // number of words
+        size_t headIndex;               // position in memory
         bool isHole = true;             // is space free or occupied?
+        listNode* prev = nullptr;       // node directly before this one in memory
+        listNode* next = nullptr;       // node directly after this one in memory
+        size_t handle = SIZE_MAX;       // handle of a relocatable block, SIZE_MAX for holes & pinned blocks
 
-        listNode(int headIndex, int size, bool isHole)
+        listNode(size_t headIndex, size_t size, bool isHole)
         {
             this->headIndex = headIndex;
         	this->size = size;
@@ -34,6 +54,242 @@ struct listNode
 };
 
 
+/*
+|--------------------------------------------------------------------------------|
+|  Occupancy Bitmap Class                                                        |
+|     - One bit per word of memory, set when the word is allocated               |
+|     - Packed into uint64_t words (word i is bit i % 64 of bits[i / 64]), so    |
+|       ranges are updated a whole uint64_t at a time & getBitmap is a memcpy    |
+|--------------------------------------------------------------------------------|
+*/
+class OccupancyBitmap
+{
+ private:
+        std::vector<uint64_t> bits;                   // packed occupancy bits, bits past sizeInWords stay 0
+        size_t sizeInWords = 0;                       // number of words of memory tracked
+
+ public:
+
+        // Mutators (used by MemoryManager only)
+        void reset(size_t sizeInWords);
+        void clear();
+        void markUsed(size_t offset, size_t size);
+        void markFree(size_t offset, size_t size);
+
+        // Accessors
+        bool isUsed(size_t offset) const;
+        size_t size() const;
+        const uint64_t* data() const;
+        size_t blockCount() const;                    // number of uint64_t in data()
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Hole Change Struct                                                            |
+|     - One change to the hole index: a hole added or removed (a hole resized in |
+|       place is removed, then added with its new size)                          |
+|     - Each change bumps the hole generation by one, so a poller holding the    |
+|       holes of generation g brings them up to date by replaying g + 1 onwards  |
+|--------------------------------------------------------------------------------|
+*/
+struct HoleChange
+{
+        uint64_t generation;                          // hole generation right after the change
+        uint64_t offset;                              // word offset of the hole
+        uint64_t size;                                // words in the hole added / removed
+        bool added;                                   // true if added, false if removed
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Hole Index Class                                                              |
+|     - Live record of every hole in memory (word offset -> size in words),      |
+|       ordered by offset and kept in sync by splitNode & mergeHoles             |
+|     - Also ordered by (size, offset) so best/worst fit are O(log n) lookups    |
+|     - Holds the occupancy bitmap of the same memory (see OccupancyBitmap)      |
+|     - Read directly by FitStrategy allocators, so no hole list is copied       |
+|     - Counts its changes (generation) & keeps the latest ones in a ring once   |
+|       trackChanges is called, for pollers reading deltas                       |
+|     - Once indexLastFit is called, also keeps a max tree of hole sizes by      |
+|       offset (one leaf per 64 words), so findLastFit is O(log n) too           |
+|--------------------------------------------------------------------------------|
+*/
+class HoleIndex
+{
+ private:
+        std::map<size_t, size_t> holesByOffset;       // word offset of each hole -> its size in words
+        std::set<std::pair<size_t, size_t>> holesBySize;   // (size, offset) of each hole, smallest first
+        OccupancyBitmap occupancy;                    // word-level view of the same holes
+        uint64_t generation = 0;                      // changes made so far, never goes back (clear counts as one)
+        std::vector<HoleChange> journal;              // ring of the latest changes (generation g at g % size), empty until trackChanges
+        uint64_t journalFloor = 0;                    // changes up to this generation are not in the journal
+        static const size_t lastFitLeafWords = 64;    // words of memory covered by each leaf of largestHoles
+        std::vector<size_t> largestHoles;             // max tree (node n has children 2n & 2n + 1, leaf i at leafBase + i): largest hole starting in the words below, empty until indexLastFit
+        size_t leafBase = 0;                          // index of the first leaf in largestHoles
+
+        void record(size_t offset, size_t size, bool added);
+        void updateLargest(size_t offset);
+
+ public:
+        using const_iterator = std::map<size_t, size_t>::const_iterator;
+
+        // Mutators (used by MemoryManager only)
+        void insert(size_t offset, size_t size);
+        void erase(size_t offset);
+        void clear();
+        OccupancyBitmap& getOccupancy();
+
+        // Accessors
+        size_t count() const;
+        const_iterator begin() const;
+        const_iterator end() const;
+        const OccupancyBitmap& getOccupancy() const;
+
+        // Size-ordered lookups, return word offset of hole or -1 (ties go to the lowest offset)
+        int64_t findBestFit(size_t sizeInWords) const;
+        int64_t findWorstFit(size_t sizeInWords) const;
+
+        // Returns word offset of the hole that contains word offset, -1 if that word is not free
+        int64_t findContaining(size_t offset) const;
+
+        // Returns word offset of the first hole starting at or after word offset, -1 if there is none
+        int64_t findNext(size_t offset) const;
+
+        // Returns word offset of the highest hole of at least sizeInWords words, -1 if no fit (O(log n) after indexLastFit, scans from the end before)
+        int64_t findLastFit(size_t sizeInWords) const;
+
+        // Starts keeping the max tree read by findLastFit (no-op once started, until clear)
+        void indexLastFit();
+
+        // Change journal: starts keeping the last capacity changes (no-op once started)
+        void trackChanges(size_t capacity = 4096);
+        uint64_t getGeneration() const;
+
+        // Calls visit for every change after generation since, oldest first; false (nothing visited) if some are no longer kept
+        bool forEachChange(uint64_t since, const std::function<void(const HoleChange& change)>& visit) const;
+};
+
+/*
+|--------------------------------------------------------------------------------|
+|  Fit Strategy Type                                                             |
+|     - Returns word offset to allocate sizeInWords at, -1 if no fit             |
+|     - The offset may be anywhere inside a hole with room for the request, the  |
+|       words before it are split back into a hole                               |
+|     - Reads the manager's live HoleIndex; unlike std::function<int(int, void*)>|
+|       allocators it never needs a getList() copy per allocation               |
+|--------------------------------------------------------------------------------|
+*/
+using FitStrategy = std::function<int64_t(size_t sizeInWords, const HoleIndex& holes)>;
+
+/*
+|--------------------------------------------------------------------------------|
+|  Hole List Formats                                                             |
+|     - Narrow16: uint16_t entries [count, offset, size, ...] (original format,  |
+|       offsets & sizes above 65535 are truncated)                               |
+|     - Wide64: same layout with uint64_t entries, for arenas of any size        |
+|     - Auto: Narrow16 for arenas of up to 65536 words, Wide64 above that        |
+|     - getBitmap's length prefix follows the format: 2 bytes for Narrow16,      |
+|       8 bytes for Wide64 (both little-endian)                                  |
+|--------------------------------------------------------------------------------|
+*/
+enum class HoleListFormat { Auto, Narrow16, Wide64 };
+
+// Allocator reading a Wide64 hole list, returns word offset of the hole to use or -1 if no fit
+using WideAllocator = std::function<int64_t(size_t sizeInWords, const uint64_t* list)>;
+
+/*
+|--------------------------------------------------------------------------------|
+|  Hole List View Struct                                                         |
+|     - Read-only hole list kept by the manager & rebuilt only when the holes    |
+|       have changed, so polling it allocates nothing                            |
+|     - Same layout & format as getList (without sub-allocator & region free     |
+|       words); the buffer is rewritten in place by later calls & only moves     |
+|       when the list outgrows it, so read it before using the manager again     |
+|     - Compare generations to skip unchanged snapshots, or read only the        |
+|       changes since with forEachHoleChange                                     |
+|--------------------------------------------------------------------------------|
+*/
+struct HoleListView
+{
+        const void* list;                             // [count, offset, size, ...] (Narrow16 or Wide64), nullptr without a memory block or with an engine
+        uint64_t generation;                          // hole generation the list shows
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Sub-Allocator Interface                                                       |
+|     - For layers that carve blocks allocated from a MemoryManager into smaller |
+|       pieces (e.g. SlabAllocator)                                              |
+|     - Reports the words inside those blocks that are free, so getList,         |
+|       getBitmap and dumpMemoryMap show them as holes                           |
+|--------------------------------------------------------------------------------|
+*/
+class SubAllocator
+{
+ public:
+        virtual ~SubAllocator() = default;
+
+        // Calls visit(word offset, size in words) for each free range, in ascending offset order
+        virtual void forEachFreeRange(const std::function<void(size_t offset, size_t size)>& visit) const = 0;
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Handle Type                                                                   |
+|     - Index of a relocatable block, turned into its current address by resolve |
+|     - Blocks allocated with allocateHandle may be moved by compaction, raw     |
+|       pointers from allocate are pinned & never move                           |
+|--------------------------------------------------------------------------------|
+*/
+using Handle = size_t;
+const Handle nullHandle = SIZE_MAX;
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Allocation Hint                                                               |
+|     - Default: placed by the allocator, as by allocate(sizeInBytes)            |
+|     - Hot: small / frequently touched blocks, packed into the lowest run of    |
+|       free words so they share cache lines & pages with each other             |
+|     - Cold: large / rarely touched buffers, carved from the top of the highest |
+|       hole that fits, so they collect at the end of memory away from hot data  |
+|     - Isolated: starts on a cache line & is padded to whole lines, so no other |
+|       block shares a line with it (no false sharing between threads)           |
+|     - Hot & Cold grow toward each other from opposite ends of memory, Default  |
+|       blocks go wherever the allocator puts them                               |
+|--------------------------------------------------------------------------------|
+*/
+enum class AllocationHint { Default, Hot, Cold, Isolated };
+const size_t cacheLineSize = 64;                      // bytes per cache line assumed by AllocationHint::Isolated
+
+const size_t defaultRegionReserve = 4096;             // bytes pushRegion() reserves for blocks bumped out of the region
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Hardened Build (make DEFINES=-DMEMORY_MANAGER_HARDENED)                       |
+|     - Each block is followed by canary bytes up to the end of an extra guard   |
+|       word, checked when the block is freed, reallocated or moved              |
+|     - Free words are poisoned & checked before they are handed out again, so   |
+|       stores through dangling pointers are caught                              |
+|     - Freed blocks wait in a FIFO quarantine (up to 1/8 of memory by default,  |
+|       see setQuarantineLimit) before they become holes, which also catches     |
+|       blocks freed twice                                                       |
+|     - Holes, canaries & quarantined blocks are marked unaddressable for ASan & |
+|       Valgrind, which otherwise see the whole memory block as valid            |
+|     - Canaries cover engine blocks too, poison & quarantine the hole list only |
+|       (page purge is off, released pages would lose their poison)              |
+|     - Problems go to the corruption handler (default: print & abort); without  |
+|       the define every check is compiled out                                   |
+|--------------------------------------------------------------------------------|
+*/
+using CorruptionHandler = std::function<void(const char* problem, void* address)>;
+
+
 /*
 |--------------------------------------------------------------------------------|
 |  MemoryManager Class Declaration                                               |
@@ -43,45 +299,253 @@ struct listNode
 class MemoryManager
 {
  private:
-        std::vector<listNode> listNodes;              // Vector representing nodes in memory
-        std::vector<uint64_t> memoryBlock;            // Vector representing a memory block
+        listNode* firstNode = nullptr;                // head of the linked list of nodes in memory
+        std::deque<listNode> nodePool;                // storage for nodes (addresses stay stable as it grows)
+        std::vector<listNode*> spareNodes;            // nodes from merged holes, reused by later splits
+        ArenaStore memoryBlock;                       // bytes representing a memory block
+        BackingStore backingStore = BackingStore::Heap;   // store used for the memory block at the next initialize
 
-        std::map<int, int> indexToNodeMap;            // mapping of listNodes to locations in memory
+        std::unordered_map<size_t, listNode*> indexToNodeMap;    // mapping of locations in memory to their nodes (O(1) lookup in free)
+        HoleIndex holes;                              // live index of holes, read by fitStrategy
+        std::unique_ptr<AllocatorEngine> engine;      // engine placing blocks instead of the hole list (nullptr for EngineType::HoleList)
+        EngineType engineType = EngineType::HoleList; // type of engine
 
-        uint64_t* start;                              // pointer to start of memory block
+        uint8_t* start = nullptr;                     // pointer to start of memory block
         unsigned wordSize;                            // value representing length of words
-        size_t memLimit;                              // value representing number of bytes available from start
+        size_t memLimit = 0;                          // value representing number of bytes available from start
+        size_t memWords = 0;                          // value representing number of words available from start
 
         std::function<int(int, void*)> algorithmType; // allocator algorithm used for determining which holes to use
+        FitStrategy fitStrategy;                      // allocator reading holes directly (used instead of algorithmType when set)
+        WideAllocator wideAlgorithmType;              // allocator reading a Wide64 hole list (used instead of algorithmType when set)
+        HoleListFormat holeListFormat = HoleListFormat::Auto;   // format of lists returned by getList / given to algorithmType
+        std::vector<const SubAllocator*> subAllocators;   // layers whose free ranges are reported as holes
+
+        std::vector<size_t> handleOffsets;            // word offset of each handle's block, SIZE_MAX for unused handles
+        std::vector<Handle> spareHandles;             // unused handles, reused before the table grows
+        size_t compactCursor = 0;                     // word offset the next compactStep resumes from
+
+        struct Region
+        {
+                size_t offset = 0;                    // word offset of the reserved block blocks are bumped out of
+                size_t size = 0;                      // words in the reserved block (0 if none)
+                size_t used = 0;                      // words bumped out so far
+                bool fromParent = false;              // reserved block was bumped out of the enclosing region
+                std::vector<void*> overflow;          // blocks placed as usual while the region was innermost
+        };
+        std::vector<Region> regions;                  // active regions, innermost last
+        std::unordered_map<size_t, std::pair<size_t, size_t>> recordedBlocks;    // word offset of each recorded block -> (index in regions, index in its overflow)
+
+        AllocatorStats stats;                         // always-on counters (latencies sampled), reset by initialize
+        AllocationSampler sampler;                    // sampled live blocks & their stacks
+        int64_t bytesUntilSample = INT64_MAX;         // requested bytes left before the next sample (never runs out while sampling is off)
+
+        struct DirtyHole
+        {
+                uint64_t freedAt;                     // AllocatorStats::now() when the hole formed
+                size_t offset;                        // word offset of the hole then
+                size_t size;                          // words in the hole then
+        };
+        static const size_t maxDirtyHoles = 1024;     // most holes waiting for their pages to be released (the oldest is dropped past it)
+        size_t purgeThreshold = 0;                    // holes of at least this many words release their pages (0 = never)
+        uint64_t purgeDecay = 0;                      // nanoseconds a hole stays free before its pages are released
+        bool lazyPurge = false;                       // release with MADV_FREE rather than MADV_DONTNEED
+        std::deque<DirtyHole> dirtyHoles;             // large holes whose pages may still be resident, oldest first
+        std::vector<uint64_t> purgedPages;            // bit per page of the memory block, set once released (cleared when a word of it is used)
+
+        std::vector<uint16_t> narrowView;             // hole index as a Narrow16 list, rebuilt when the holes have changed (see HoleListView)
+        std::vector<uint64_t> wideView;               // same, as a Wide64 list
+        uint64_t narrowViewGeneration = UINT64_MAX;   // hole generation each list was built at
+        uint64_t wideViewGeneration = UINT64_MAX;
+
+        PersistentArena persistentArena;              // file holding the memory block & its blocks after attach (closed otherwise)
+        size_t rootOffset = SIZE_MAX;                 // word offset of the root block kept by sync, SIZE_MAX if none
+
+        std::unordered_map<size_t, size_t> guardedBlocks;  // hardened: word offset of each block -> bytes asked for, SIZE_MAX while quarantined
+        std::deque<size_t> quarantine;                // hardened: word offsets of freed blocks not yet turned into holes, oldest first
+        size_t quarantinedWords = 0;                  // hardened: words held by those blocks
+        size_t quarantineLimit = SIZE_MAX;            // hardened: bytes those blocks may take before the oldest become holes (SIZE_MAX: 1/8 of memory)
+        CorruptionHandler corruptionHandler;          // called by hardened checks (empty: print & abort)
 
  public:
 
         // Constructor / Destructor
         MemoryManager(unsigned wordSize, std::function<int(int, void*)> allocator);        
+        MemoryManager(unsigned wordSize, FitStrategy strategy);
+        MemoryManager(unsigned wordSize, WideAllocator allocator);
         ~MemoryManager();
 
         // Initialize / Release Memory Block
         void initialize(size_t sizeInWords);
+        void initialize(size_t sizeInWords, EngineType engineType);
         void shutdown();
 
         // Allocate / Deallocate Sections Of Memory
         void* allocate(size_t sizeInBytes);
         void free(void* address);
+        size_t allocateBatch(const std::vector<size_t>& sizesInBytes, std::vector<void*>& out);
+        void freeBatch(const std::vector<void*>& addresses);
+        void* reallocate(void* address, size_t newSizeInBytes);
+        void* allocateAligned(size_t sizeInBytes, size_t alignment);
+        void* allocate(size_t sizeInBytes, AllocationHint hint);
+
+        // Typed Allocation (constructs / destroys T in place, nullptr if no memory available)
+        // create is never inlined, so the stack of a sampled object starts at the code calling create
+        template <typename T, typename... Args>
+        __attribute__((noinline)) T* create(Args&&... args)
+        {
+                void* address = allocateAlignedFrom(sizeof(T), alignof(T), __builtin_return_address(0));
+                if (address == nullptr)
+                {
+                        return nullptr;
+                }
+                try
+                {
+                        return new (address) T(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                        free(address);
+                        throw;
+                }
+        }
+
+        template <typename T>
+        void destroy(T* object)
+        {
+                if (object != nullptr)
+                {
+                        object->~T();
+                        free(object);
+                }
+        }
+
+        // Relocatable Blocks / Compaction
+        Handle allocateHandle(size_t sizeInBytes);
+        void* resolve(Handle handle);
+        void freeHandle(Handle handle);
+        void compact();
+        bool compactStep(size_t budgetInWords);
+
+        // Regions (Bulk Free)
+        void pushRegion(size_t reserveInBytes = defaultRegionReserve);
+        void popRegion();
+        size_t getRegionDepth();
+        void* allocateOutsideRegion(size_t sizeInBytes);
 
         // Set Functions (Mutators)
         void setAllocator(std::function<int(int, void*)> allocator);
+        void setAllocator(FitStrategy strategy);
+        void setAllocator(WideAllocator allocator);
+        void setHoleListFormat(HoleListFormat format);
+        void setBackingStore(BackingStore type);
+        void attachSubAllocator(const SubAllocator* subAllocator);
+        void detachSubAllocator(const SubAllocator* subAllocator);
         int dumpMemoryMap(char* filename);
+        int dumpMemoryMapBinary(char* filename);
+        int dumpMemoryMapBinary(int fd);
+        int dumpMemoryMapBinary(const DumpSink& sink);
 
         // Get Functions (Accessors)
         void* getList();
         void* getBitmap();
         unsigned getWordSize();
         void* getMemoryStart();
-        unsigned getMemoryLimit();
+        size_t getMemoryLimit();
+        HoleListFormat getHoleListFormat();
+        BackingStore getBackingStore();
+        EngineType getEngineType();
+        const HoleIndex& getHoleIndex() const;
+        size_t wordsFor(size_t sizeInBytes);
+        bool isEmpty();
+
+        // Hole List View (no copy per call, see HoleListView)
+        HoleListView getHoleListView();
+        uint64_t getHoleGeneration() const;
+        bool forEachHoleChange(uint64_t sinceGeneration, const std::function<void(const HoleChange& change)>& visit);
+
+        // Statistics
+        MemoryStats getStats();
+        const AllocatorStats& getAllocatorStats() const;
+        void resetStats();
+        void setLatencySampling(unsigned everyNthCall);
+
+        // Page Release (Mmap / HugePages arenas)
+        void setPagePurge(size_t thresholdInBytes, uint64_t decayInMilliseconds = 1000, bool lazy = false);
+        size_t purgePages(bool ignoreDecay = false);
+
+        // Persistent Arena (File-Backed, Survives Restarts)
+        // Limitation: attach reads the whole block list of the last sync & rebuilds a node per block, so reattaching is O(blocks) in
+        // time & memory (not O(1) like the mapping itself); sync writes the whole list too, so both grow with the number of live blocks
+        bool attach(char* filename, size_t sizeInWords);
+        bool sync();
+        void setRoot(void* address);
+        void* getRoot();
+
+        // Hardened Build (checks compiled in with -DMEMORY_MANAGER_HARDENED)
+        static bool isHardened();
+        void setCorruptionHandler(CorruptionHandler handler);
+        void setQuarantineLimit(size_t bytes);
+
+        // Allocation Sampling (Heap Profile)
+        void setSamplingInterval(size_t bytes);
+        size_t getSamplingInterval();
+        std::vector<SampledAllocation> getSampledAllocations();
+        int dumpHeapProfile(char* filename);
 
 		// Helper functions
-		void splitNode(int nodePosition, int availableHole, size_t sizeInWords);
-		void mergeHoles(int nodePosition);
+		void splitNode(listNode* node, size_t sizeInWords);
+		void mergeHoles(listNode* node);
+		listNode* splitHoleAt(listNode* node, size_t offset);
+
+ private:
+        listNode* newNode(size_t headIndex, size_t size, bool isHole);
+        void unlinkNode(listNode* node);
+        int64_t findHole(size_t sizeInWords);
+        void splitBlock(listNode* node, size_t sizeInWords);
+        void slideDown(listNode* hole);
+        void releaseHandle(listNode* node);
+        void markUsed(size_t offset, size_t size);
+        void markFree(size_t offset, size_t size);
+        void* allocateWords(size_t sizeInWords);
+        bool growInPlace(listNode* node, size_t sizeInWords);
+        void* allocateInRegion(size_t sizeInWords);
+        bool inRegion(size_t offset);
+        void recordInRegion(void* address);
+        void forgetRecorded(size_t offset);
+        bool hasOverlay();
+        void forEachOverlayRange(const std::function<void(size_t offset, size_t size)>& visit);
+        uint16_t* getNarrowList(bool reported);
+        uint64_t* getWideList(bool reported);
+        const uint16_t* getNarrowView();
+        const uint64_t* getWideView();
+        std::vector<std::pair<size_t, size_t>> getReportedHoles();
+        MemoryMapWriter encodeMemoryMap();
+        void sampleAllocation(void* address, size_t sizeInBytes, const void* caller);
+        void* allocateAlignedFrom(size_t sizeInBytes, size_t alignment, const void* caller);
+        void* allocateAlignedWords(size_t sizeInWords, size_t alignInWords, size_t phase);
+        void* allocateHinted(size_t sizeInWords, AllocationHint hint);
+        void resetPurgedPages(bool released);
+        void clearPurgedPages(size_t offset, size_t size);
+        void queueDirtyHole(size_t offset, size_t size);
+        size_t releaseHolePages(size_t fromWord, size_t toWord);
+        bool rebuildBlocks(const std::vector<PersistentBlock>& blocks);
+        bool alignmentPhase(size_t alignment, size_t& alignInWords, size_t& phase);
+        void freeNode(listNode* node);
+        void armBlock(void* address, size_t sizeInBytes);
+        bool checkBlock(size_t offset, const char* freedProblem);
+        bool quarantineBlock(listNode* node);
+        size_t quarantineLimitInWords();
+        void releaseQuarantined(size_t keepWords);
+        void poisonWords(size_t offset, size_t size);
+        void checkPoison(size_t offset, size_t size);
+        void reportCorruption(const char* problem, size_t offset);
+
+ protected:
+        listNode* claimHole(int64_t availableHole, size_t sizeInWords);
+        uint64_t startTiming();
+        void* allocateFrom(size_t sizeInBytes, const void* caller);
+        void* finishAllocate(void* address, size_t sizeInWords, size_t sizeInBytes, uint64_t began, const void* caller);
 };
 
 
@@ -93,3 +557,26 @@ class MemoryManager
 */
 int bestFit(int sizeInWords, void* list);
 int worstFit(int sizeInWords, void* list);
+
+// Same algorithms over a Wide64 hole list (no 65535 word limit on offsets or sizes)
+int64_t bestFitWide(size_t sizeInWords, const uint64_t* list);
+int64_t worstFitWide(size_t sizeInWords, const uint64_t* list);
+
+// Built-in fit strategies over the size-ordered hole index (same choices as bestFit / worstFit in O(log n))
+int64_t indexedBestFit(size_t sizeInWords, const HoleIndex& holes);
+int64_t indexedWorstFit(size_t sizeInWords, const HoleIndex& holes);
+
+// Built-in fit strategy over the occupancy bitmap: lowest-offset run of free words (vectorised scan, see BitmapScan.h)
+int64_t bitmapFirstFit(size_t sizeInWords, const HoleIndex& holes);
+
+// Built-in fit strategy over the occupancy bitmap: scan resumes where the previous allocation ended, wrapping around once
+// The manager moves the cursor through claimed() once a block is actually handed out, a rejected or unused offset leaves it be
+class BitmapNextFit
+{
+ private:
+        size_t cursor = 0;                            // word offset just past the last block handed out
+
+ public:
+        int64_t operator()(size_t sizeInWords, const HoleIndex& holes);
+        void claimed(size_t offset, size_t sizeInWords);
+};
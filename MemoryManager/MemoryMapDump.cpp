@@ -0,0 +1,252 @@
+#include "MemoryMapDump.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/*--------------------------------------------|
+|      MemoryMapWriter Class Definitions      |
+|--------------------------------------------*/
+
+/* CONSTRUCTOR:
+Encodes the magic, version & header fields
+*/
+MemoryMapWriter::MemoryMapWriter(unsigned wordSize, size_t sizeInWords, size_t holeCount)
+{
+    for (uint8_t byte : memoryMapMagic)
+    {
+        putByte(byte);
+    }
+    putByte(memoryMapVersion);
+    putVarint(wordSize);
+    putVarint(sizeInWords);
+    putVarint(holeCount);
+}
+
+/* ADD HOLE:
+Encodes the next hole as its gap from the previous hole & its size
+*/
+void MemoryMapWriter::addHole(size_t offset, size_t size)
+{
+    putVarint(offset - previousEnd);
+    putVarint(size);
+    previousEnd = offset + size;
+}
+
+/* WRITE TO:
+Writes every chunk to fd with writev (at most IOV_MAX chunks per call), resuming where a short write stopped
+*/
+int MemoryMapWriter::writeTo(int fd) const
+{
+    std::vector<iovec> pieces;
+    for (const std::vector<uint8_t> &chunk : chunks)
+    {
+        pieces.push_back(iovec{(void *)chunk.data(), chunk.size()});
+    }
+
+    size_t next = 0;
+    while (next < pieces.size())
+    {
+        ssize_t written = writev(fd, &pieces[next], std::min<size_t>(IOV_MAX, pieces.size() - next));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+
+        // Skip the pieces written in full, the first one left may be partly written
+        while (next < pieces.size() && (size_t)written >= pieces[next].iov_len)
+        {
+            written -= pieces[next].iov_len;
+            next++;
+        }
+        if (next < pieces.size())
+        {
+            pieces[next].iov_base = (uint8_t *)pieces[next].iov_base + written;
+            pieces[next].iov_len -= written;
+        }
+    }
+    return 0;
+}
+
+/* SEND TO:
+Hands every chunk to sink in order, stopping if it returns false
+*/
+int MemoryMapWriter::sendTo(const DumpSink &sink) const
+{
+    for (const std::vector<uint8_t> &chunk : chunks)
+    {
+        if (!sink(chunk.data(), chunk.size()))
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* SIZE:
+Returns the bytes encoded so far
+*/
+size_t MemoryMapWriter::size() const
+{
+    size_t bytes = 0;
+    for (const std::vector<uint8_t> &chunk : chunks)
+    {
+        bytes += chunk.size();
+    }
+    return bytes;
+}
+
+// Helper function: appends a byte, starting a new chunk when the last one is full
+void MemoryMapWriter::putByte(uint8_t byte)
+{
+    if (chunks.empty() || chunks.back().size() == chunkBytes)
+    {
+        chunks.emplace_back();
+        chunks.back().reserve(chunkBytes);
+    }
+    chunks.back().push_back(byte);
+}
+
+// Helper function: appends value as an unsigned LEB128 varint (7 bits per byte, low bits first, high bit set on all but the last byte)
+void MemoryMapWriter::putVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        putByte((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    putByte((uint8_t)value);
+}
+
+
+/*--------------------------------------------|
+|        Memory Map Reader Definitions        |
+|--------------------------------------------*/
+
+// Helper function: reads an unsigned LEB128 varint at position, returns false if it is truncated or longer than 64 bits
+static bool getVarint(const uint8_t *data, size_t bytes, size_t &position, uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (position == bytes)
+        {
+            return false;
+        }
+        uint8_t byte = data[position++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* READ MEMORY MAP:
+Decodes a binary memory map held in memory
+*/
+bool readMemoryMap(const uint8_t *data, size_t bytes, MemoryMapSnapshot &snapshot)
+{
+    size_t position = sizeof(memoryMapMagic) + 1;
+    if (bytes < position || memcmp(data, memoryMapMagic, sizeof(memoryMapMagic)) != 0 || data[sizeof(memoryMapMagic)] != memoryMapVersion)
+    {
+        return false;
+    }
+
+    uint64_t wordSize, sizeInWords, holeCount;
+    if (!getVarint(data, bytes, position, wordSize) || !getVarint(data, bytes, position, sizeInWords) ||
+        !getVarint(data, bytes, position, holeCount) || wordSize == 0 || wordSize > UINT_MAX)
+    {
+        return false;
+    }
+
+    // Each hole takes at least 2 bytes, so a corrupt count cannot make the vector huge
+    if (holeCount > (bytes - position) / 2)
+    {
+        return false;
+    }
+
+    snapshot.wordSize = wordSize;
+    snapshot.sizeInWords = sizeInWords;
+    snapshot.holes.clear();
+    snapshot.holes.reserve(holeCount);
+
+    uint64_t previousEnd = 0;
+    for (uint64_t i = 0; i < holeCount; i++)
+    {
+        uint64_t gap, size;
+        if (!getVarint(data, bytes, position, gap) || !getVarint(data, bytes, position, size) || size == 0 ||
+            gap > sizeInWords - previousEnd || size > sizeInWords - previousEnd - gap)
+        {
+            return false;
+        }
+        snapshot.holes.push_back({previousEnd + gap, size});
+        previousEnd += gap + size;
+    }
+    return position == bytes;
+}
+
+/* READ MEMORY MAP:
+Same as above, reading the map from a file written by dumpMemoryMapBinary
+*/
+bool readMemoryMap(const char *filename, MemoryMapSnapshot &snapshot)
+{
+    int file = open(filename, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[64 * 1024];
+    while (true)
+    {
+        ssize_t got = read(file, buffer, sizeof(buffer));
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            close(file);
+            return got == 0 && readMemoryMap(data.data(), data.size(), snapshot);
+        }
+        data.insert(data.end(), buffer, buffer + got);
+    }
+}
+
+/* WRITE FULLY:
+Writes all bytes, looping over short writes & retrying calls interrupted by signals
+*/
+int writeFully(int fd, const void *data, size_t bytes)
+{
+    const uint8_t *next = static_cast<const uint8_t *>(data);
+    while (bytes > 0)
+    {
+        ssize_t written = write(fd, next, bytes);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        next += written;
+        bytes -= written;
+    }
+    return 0;
+}
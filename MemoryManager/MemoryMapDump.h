@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Binary Memory Map Format                                                      |
+|     - "MMAP", format version byte (1), then unsigned LEB128 varints:           |
+|           wordSize, sizeInWords, holeCount,                                    |
+|           holeCount x (gap, size)                                              |
+|     - gap is the number of words between the end of the previous hole (0 for   |
+|       the first) & the start of this one, i.e. the allocated run before it     |
+|     - Holes are in ascending offset order, sizes & offsets in words            |
+|     - Takes a few bytes per hole, however large the arena is                   |
+|--------------------------------------------------------------------------------|
+*/
+const uint8_t memoryMapMagic[4] = {'M', 'M', 'A', 'P'};
+const uint8_t memoryMapVersion = 1;
+
+// Receives a dump piece by piece, returns false to stop the dump
+using DumpSink = std::function<bool(const uint8_t* data, size_t bytes)>;
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  MemoryMapWriter Class Declaration                                             |
+|   - Encodes a whole binary memory map into fixed-size chunks before any of it  |
+|     is written, so the dump is one consistent snapshot even if the sink        |
+|     calls back into the manager                                                |
+|   - writeTo sends the chunks with writev, resuming after short writes          |
+|--------------------------------------------------------------------------------|
+*/
+class MemoryMapWriter
+{
+ private:
+        static const size_t chunkBytes = 64 * 1024;   // bytes per chunk (one iovec each)
+        std::vector<std::vector<uint8_t>> chunks;
+        size_t previousEnd = 0;                       // word offset just past the last hole added
+
+        void putByte(uint8_t byte);
+        void putVarint(uint64_t value);
+
+ public:
+        // Writes the header, holeCount holes must then be added in ascending offset order
+        MemoryMapWriter(unsigned wordSize, size_t sizeInWords, size_t holeCount);
+
+        void addHole(size_t offset, size_t size);
+
+        // Return 0 on success, -1 if a write failed or the sink stopped the dump
+        int writeTo(int fd) const;
+        int sendTo(const DumpSink& sink) const;
+
+        size_t size() const;                          // bytes encoded so far
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  Memory Map Snapshot Reader                                                    |
+|   - Loads a binary memory map back into its holes, for offline tools           |
+|   - Returns false (snapshot unspecified) if the data is not a valid map: bad   |
+|     magic or version, truncated, trailing bytes, or holes that overlap or run  |
+|     past the end of the memory block                                          |
+|--------------------------------------------------------------------------------|
+*/
+struct MemoryMapSnapshot
+{
+        unsigned wordSize = 0;
+        size_t sizeInWords = 0;
+        std::vector<std::pair<size_t, size_t>> holes; // (word offset, size in words) of each hole
+};
+
+bool readMemoryMap(const uint8_t* data, size_t bytes, MemoryMapSnapshot& snapshot);
+bool readMemoryMap(const char* filename, MemoryMapSnapshot& snapshot);
+
+// Writes all bytes to fd, retrying short writes & interrupted calls; returns 0 on success, -1 on error
+int writeFully(int fd, const void* data, size_t bytes);
@@ -0,0 +1,326 @@
+#include "NumaMemoryManager.h"
+
+#include <fstream>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <thread>
+
+// mbind policy & flag (linux/mempolicy.h), used through syscall so libnuma is not needed
+static const int mpolBind = 2;
+static const unsigned mpolMoveFlag = 1 << 1;                  // MPOL_MF_MOVE: pages touched already (poisoned holes of hardened builds) move to the node too
+
+// Helper function: parses a kernel list such as "0-3,8,10-11" into its numbers
+static std::vector<int> parseList(const std::string &list)
+{
+    std::vector<int> numbers;
+    size_t position = 0;
+    while (position < list.size())
+    {
+        size_t end = list.find(',', position);
+        std::string range = list.substr(position, end == std::string::npos ? std::string::npos : end - position);
+        size_t dash = range.find('-');
+
+        if (!range.empty() && isdigit((unsigned char)range[0]))
+        {
+            int first = std::stoi(range);
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int number = first; number <= last; number++)
+            {
+                numbers.push_back(number);
+            }
+        }
+        position = end == std::string::npos ? list.size() : end + 1;
+    }
+    return numbers;
+}
+
+// Helper function: writes a byte back unchanged, placing its page without touching the holes' contents (poisoned in hardened builds)
+__attribute__((no_sanitize_address)) static void touchPage(volatile uint8_t *byte)
+{
+    *byte = *byte;
+}
+
+// Helper function: first line of a sysfs file, empty if it cannot be read
+static std::string readLine(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+
+/*--------------------------------------------|
+|    NumaMemoryManager Class Definitions      |
+|--------------------------------------------*/
+
+NumaMemoryManager::NodeArena::NodeArena(int nodeId, unsigned wordSize, const FitStrategy &strategy, const std::function<int(int, void *)> &allocator)
+    : nodeId(nodeId), arena(strategy ? MemoryManager(wordSize, strategy) : MemoryManager(wordSize, allocator))
+{
+}
+
+/* CONTSTRUCTOR:
+Sets word size & the allocator each arena uses for finding a memory hole
+*/
+NumaMemoryManager::NumaMemoryManager(unsigned wordSize, std::function<int(int, void *)> allocator)
+    : wordSize(wordSize), algorithmType(allocator)
+{
+}
+
+NumaMemoryManager::NumaMemoryManager(unsigned wordSize, FitStrategy strategy)
+    : wordSize(wordSize), fitStrategy(strategy)
+{
+}
+
+/* DESTRUCTOR:
+Releases every arena
+*/
+NumaMemoryManager::~NumaMemoryManager()
+{
+    shutdown();
+}
+
+/* INITIALIZER:
+Maps an arena of sizeInWordsPerNode words for each node & places it there with the given policy, cleans up previous arenas if applicable
+If the policy cannot be applied to an arena (see isBound), its pages go wherever they are first touched
+*/
+void NumaMemoryManager::initialize(size_t sizeInWordsPerNode, NumaPolicy policy)
+{
+    shutdown();
+    if (sizeInWordsPerNode == 0)
+    {
+        return;
+    }
+
+    discoverNodes();
+    for (auto &node : nodes)
+    {
+        node->arena.setBackingStore(BackingStore::Mmap);          // no page is placed before the policy is applied
+        if (policy == NumaPolicy::Bind)
+        {
+            node->arena.initialize(sizeInWordsPerNode);
+            node->bound = node->arena.getMemoryStart() != nullptr && bindArena(*node);
+        }
+        else
+        {
+            node->bound = touchArena(*node, sizeInWordsPerNode);  // initialized on the node, hardened builds poison every page there
+        }
+        if (node->arena.getMemoryStart() == nullptr)
+        {
+            shutdown();
+            return;
+        }
+
+        directory.insert(node->arena.getMemoryStart(), node->arena.getMemoryLimit(), node.get());
+    }
+}
+
+/* RELEASER:
+Releases every arena (blocks in them are gone)
+*/
+void NumaMemoryManager::shutdown()
+{
+    nodes.clear();
+    nodeOfCpu.clear();
+    directory.clear();
+}
+
+/* ALLOCATOR:
+Allocates from the arena of the calling thread's node, or from the other nodes in order if it is full
+Returns nullptr if no memory available or invalid size
+*/
+void *NumaMemoryManager::allocate(size_t sizeInBytes)
+{
+    if (nodes.empty())
+    {
+        return nullptr;
+    }
+
+    unsigned local = getCurrentNode();
+    for (unsigned i = 0; i < nodes.size(); i++)
+    {
+        void *address = allocateOnNode(sizeInBytes, (local + i) % nodes.size());
+        if (address)
+        {
+            return address;
+        }
+    }
+    return nullptr;
+}
+
+/* NODE ALLOCATOR:
+Allocates from the arena of one node (index in node number order), returns nullptr if it has no room
+*/
+void *NumaMemoryManager::allocateOnNode(size_t sizeInBytes, unsigned node)
+{
+    if (node >= nodes.size())
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(nodes[node]->lock);
+    return nodes[node]->arena.allocate(sizeInBytes);
+}
+
+/* DEALLOCATOR:
+Frees the block in the arena holding it
+*/
+void NumaMemoryManager::free(void *address)
+{
+    NodeArena *node = directory.find(address);
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(node->lock);
+    node->arena.free(address);
+}
+
+/* GET WORD SIZE:
+Returns word size used for alignment
+*/
+unsigned NumaMemoryManager::getWordSize()
+{
+    return wordSize;
+}
+
+/* GET MEMORY LIMIT:
+Returns the bytes in all arenas
+*/
+size_t NumaMemoryManager::getMemoryLimit()
+{
+    size_t memLimit = 0;
+    for (auto &node : nodes)
+    {
+        memLimit += node->arena.getMemoryLimit();
+    }
+    return memLimit;
+}
+
+/* GET NODE COUNT:
+Returns the number of nodes (& arenas), 0 before initialize
+*/
+unsigned NumaMemoryManager::getNodeCount()
+{
+    return nodes.size();
+}
+
+/* GET CURRENT NODE:
+Returns the index of the calling thread's node (0 if the CPU is unknown)
+*/
+unsigned NumaMemoryManager::getCurrentNode()
+{
+    int cpu = sched_getcpu();
+    return (cpu >= 0 && (size_t)cpu < nodeOfCpu.size()) ? nodeOfCpu[cpu] : 0;
+}
+
+/* GET NODE ID:
+Returns the kernel node number of a node, -1 if there is no such node
+*/
+int NumaMemoryManager::getNodeId(unsigned node)
+{
+    return node < nodes.size() ? nodes[node]->nodeId : -1;
+}
+
+/* IS BOUND:
+Returns whether the placement policy was applied to a node's arena
+*/
+bool NumaMemoryManager::isBound(unsigned node)
+{
+    return node < nodes.size() && nodes[node]->bound;
+}
+
+/* GET ARENA:
+Returns a node's arena (not thread-safe)
+*/
+MemoryManager &NumaMemoryManager::getArena(unsigned node)
+{
+    return nodes[node]->arena;
+}
+
+/* FIND NODE:
+Returns the index of the node whose arena holds address, -1 if none does
+*/
+int NumaMemoryManager::findNode(void *address)
+{
+    NodeArena *node = directory.find(address);
+    for (unsigned i = 0; node && i < nodes.size(); i++)
+    {
+        if (nodes[i].get() == node)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Helper function: one (uninitialized) arena per online node with its CPUs, & the node of every CPU
+void NumaMemoryManager::discoverNodes()
+{
+    std::vector<int> nodeIds = parseList(readLine("/sys/devices/system/node/online"));
+    if (nodeIds.empty())
+    {
+        nodeIds.push_back(0);
+    }
+
+    for (int nodeId : nodeIds)
+    {
+        nodes.emplace_back(new NodeArena(nodeId, wordSize, fitStrategy, algorithmType));
+        nodes.back()->cpus = parseList(readLine("/sys/devices/system/node/node" + std::to_string(nodeId) + "/cpulist"));
+
+        for (int cpu : nodes.back()->cpus)
+        {
+            if ((size_t)cpu >= nodeOfCpu.size())
+            {
+                nodeOfCpu.resize(cpu + 1, 0);
+            }
+            nodeOfCpu[cpu] = nodes.size() - 1;
+        }
+    }
+}
+
+// Helper function: binds the arena's pages to its node (MPOL_BIND, moving pages placed already), returns false if mbind is refused
+bool NumaMemoryManager::bindArena(NodeArena &node)
+{
+    const size_t bitsPerLong = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> nodeMask(node.nodeId / bitsPerLong + 1, 0);
+    nodeMask[node.nodeId / bitsPerLong] |= 1UL << (node.nodeId % bitsPerLong);
+
+    // The kernel reads maxnode - 1 bits of the mask
+    long result = syscall(SYS_mbind, node.arena.getMemoryStart(), node.arena.getMemoryLimit(), mpolBind,
+                          nodeMask.data(), nodeMask.size() * bitsPerLong + 1, mpolMoveFlag);
+    return result == 0;
+}
+
+// Helper function: initializes the arena of sizeInWords words & writes one byte of every page from a thread pinned to the node's CPUs
+// Returns false if the thread could not be pinned (the arena is still initialized, its pages go wherever that thread runs)
+bool NumaMemoryManager::touchArena(NodeArena &node, size_t sizeInWords)
+{
+    bool pinned = false;
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+
+    // Hardened builds poison the whole arena in initialize, so it runs on the pinned thread as well
+    std::thread toucher([&]() {
+        if (!node.cpus.empty())
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (int cpu : node.cpus)
+            {
+                CPU_SET(cpu, &cpus);
+            }
+            pinned = sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+        }
+
+        node.arena.initialize(sizeInWords);
+        uint8_t *start = static_cast<uint8_t *>(node.arena.getMemoryStart());
+        size_t bytes = node.arena.getMemoryLimit();
+        for (size_t offset = 0; pinned && offset < bytes; offset += pageSize)
+        {
+            touchPage(start + offset);
+        }
+    });
+    toucher.join();
+    return pinned && node.arena.getMemoryStart() != nullptr;
+}
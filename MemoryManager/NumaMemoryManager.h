@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "MemoryManager.h"
+#include "ChunkDirectory.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  NUMA Placement Policies                                                       |
+|     - Bind: each arena is bound to its node with mbind (MPOL_BIND), pages are  |
+|       placed there whichever thread touches them first (pages the hardened     |
+|       build poisoned before are moved, MPOL_MF_MOVE)                           |
+|     - FirstTouch: each arena is initialized & touched once, page by page, by a |
+|       thread pinned to the node's CPUs                                         |
+|--------------------------------------------------------------------------------|
+*/
+enum class NumaPolicy { Bind, FirstTouch };
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  NumaMemoryManager Class Declaration                                           |
+|   - One mmap-backed arena (a MemoryManager) per NUMA node, each with its lock  |
+|   - allocate uses the arena of the node the calling thread runs on, falling    |
+|     back to the other nodes in order when it is full                          |
+|   - free finds the arena of an address through a ChunkDirectory                |
+|   - Nodes & their CPUs come from /sys/devices/system/node (one node with every |
+|     CPU if that is missing)                                                    |
+|--------------------------------------------------------------------------------|
+*/
+class NumaMemoryManager
+{
+ private:
+        struct NodeArena
+        {
+                int nodeId;                           // kernel node number
+                MemoryManager arena;                  // only touched under lock
+                std::mutex lock;
+                bool bound = false;                   // placement policy could be applied
+                std::vector<int> cpus;                // CPUs of the node
+
+                NodeArena(int nodeId, unsigned wordSize, const FitStrategy& strategy, const std::function<int(int, void*)>& allocator);
+        };
+
+        unsigned wordSize;
+        std::function<int(int, void*)> algorithmType; // allocator given to each arena (if no fitStrategy)
+        FitStrategy fitStrategy;                      // fit strategy given to each arena
+
+        std::vector<std::unique_ptr<NodeArena>> nodes;    // arenas in node number order
+        std::vector<unsigned> nodeOfCpu;              // index in nodes of each CPU's node
+        ChunkDirectory<NodeArena> directory;          // address range of each arena (fixed between initialize & shutdown)
+
+ public:
+
+        // Constructor / Destructor
+        NumaMemoryManager(unsigned wordSize, std::function<int(int, void*)> allocator);
+        NumaMemoryManager(unsigned wordSize, FitStrategy strategy);
+        ~NumaMemoryManager();
+
+        // Initialize / Release Arenas (not thread-safe, no other calls may run at the same time)
+        void initialize(size_t sizeInWordsPerNode, NumaPolicy policy);
+        void shutdown();
+
+        // Allocate / Deallocate Sections Of Memory (thread-safe)
+        void* allocate(size_t sizeInBytes);
+        void* allocateOnNode(size_t sizeInBytes, unsigned node);
+        void free(void* address);
+
+        // Get Functions (Accessors)
+        unsigned getWordSize();
+        size_t getMemoryLimit();
+        unsigned getNodeCount();
+        unsigned getCurrentNode();
+        int getNodeId(unsigned node);
+        bool isBound(unsigned node);
+        MemoryManager& getArena(unsigned node);       // not thread-safe, for getList / getBitmap while no other calls run
+        int findNode(void* address);
+
+ private:
+        void discoverNodes();
+        bool bindArena(NodeArena& node);
+        bool touchArena(NodeArena& node, size_t sizeInWords);
+};
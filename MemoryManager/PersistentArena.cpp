@@ -0,0 +1,256 @@
+#include "PersistentArena.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Helper function: 64-bit FNV-1a hash of bytes
+static uint64_t fnv1a(const void *data, size_t bytes)
+{
+    const uint8_t *next = static_cast<const uint8_t *>(data);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        hash = (hash ^ next[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Helper function: pwrite / pread of all bytes at offset, retrying short & interrupted calls
+static bool transferFully(int fd, void *data, size_t bytes, size_t offset, bool writing)
+{
+    uint8_t *next = static_cast<uint8_t *>(data);
+    while (bytes > 0)
+    {
+        ssize_t done = writing ? pwrite(fd, next, bytes, offset) : pread(fd, next, bytes, offset);
+        if (done < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (done <= 0)
+        {
+            return false;
+        }
+        next += done;
+        bytes -= done;
+        offset += done;
+    }
+    return true;
+}
+
+// Helper function: checksum of a header copy (every field before headerChecksum)
+static uint64_t headerChecksum(const PersistentArenaHeader &header)
+{
+    return fnv1a(&header, offsetof(PersistentArenaHeader, headerChecksum));
+}
+
+
+/*--------------------------------------------|
+|      PersistentArena Class Definitions      |
+|--------------------------------------------*/
+
+/* DESTRUCTOR:
+Closes the file (without saving, the last sync stays current)
+*/
+PersistentArena::~PersistentArena()
+{
+    close();
+}
+
+/* OPEN:
+Opens the arena in filename, or creates one of sizeInWords words if the file is empty or missing
+Returns false (nothing open) on I/O errors, if the file holds something else, or holds an arena of another word size
+*/
+bool PersistentArena::open(const char *filename, unsigned wordSize, size_t sizeInWords)
+{
+    close();
+
+    fd = ::open(filename, O_RDWR | O_CREAT, 0644);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0)
+    {
+        close();
+        return false;
+    }
+
+    // Existing arena: latest valid header copy
+    if (status.st_size != 0)
+    {
+        PersistentArenaHeader copies[2];
+        bool valid[2] = {readHeader(0, copies[0]), readHeader(1, copies[1])};
+        if (!valid[0] && !valid[1])
+        {
+            close();
+            return false;
+        }
+        currentCopy = (valid[1] && (!valid[0] || copies[1].generation > copies[0].generation)) ? 1 : 0;
+        current = copies[currentCopy];
+
+        // A header whose byte size would wrap around is as good as corrupt
+        if (current.wordSize != wordSize || current.sizeInWords > (SIZE_MAX - current.dataOffset) / wordSize ||
+            (uint64_t)status.st_size < current.dataOffset + current.sizeInWords * wordSize)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // New arena: headers, then the memory block on a page boundary
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t dataOffset = (2 * headerBytes + pageSize - 1) / pageSize * pageSize;
+    if (sizeInWords == 0 || sizeInWords > (SIZE_MAX - dataOffset) / wordSize)
+    {
+        close();
+        return false;
+    }
+
+    PersistentArenaHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, persistentArenaMagic, sizeof(header.magic));
+    header.version = persistentArenaVersion;
+    header.wordSize = wordSize;
+    header.sizeInWords = sizeInWords;
+    header.dataOffset = dataOffset;
+    header.slotChecksum = fnv1a(nullptr, 0);
+    header.rootOffset = UINT64_MAX;
+
+    if (ftruncate(fd, header.dataOffset + sizeInWords * wordSize) != 0 || !writeHeader(0, header))
+    {
+        close();
+        return false;
+    }
+    current = header;
+    currentCopy = 0;
+    return true;
+}
+
+/* CLOSE:
+Closes the file, if open
+*/
+void PersistentArena::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    fd = -1;
+    current = PersistentArenaHeader();
+    currentCopy = 0;
+}
+
+/* LOAD:
+Reads the allocated blocks & root offset of the latest sync, falling back to the sync before it if that slot is damaged
+Returns false (blocks unspecified) if neither can be read
+*/
+bool PersistentArena::load(std::vector<PersistentBlock> &blocks, uint64_t &rootOffset)
+{
+    for (unsigned attempt = 0; attempt < 2; attempt++)
+    {
+        blocks.resize(current.blockCount);
+        size_t bytes = blocks.size() * sizeof(PersistentBlock);
+        if ((bytes == 0 || transferFully(fd, blocks.data(), bytes, current.slotOffset, false)) && fnv1a(blocks.data(), bytes) == current.slotChecksum)
+        {
+            rootOffset = current.rootOffset;
+            return true;
+        }
+
+        PersistentArenaHeader other;
+        if (!readHeader(1 - currentCopy, other) || other.generation >= current.generation)
+        {
+            break;
+        }
+        currentCopy = 1 - currentCopy;
+        current = other;
+    }
+    return false;
+}
+
+/* SAVE:
+Writes blocks & rootOffset to the slot not in use, makes it durable, then flips to it by writing the other header copy
+The current slot is never overwritten, so a crash before the header reaches the disk leaves the previous sync in place
+*/
+bool PersistentArena::save(const std::vector<PersistentBlock> &blocks, uint64_t rootOffset, const void *mappedAt)
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // The new slot goes right after the memory block if it fits before the current slot, otherwise after the current slot
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t bytes = blocks.size() * sizeof(PersistentBlock);
+    size_t slotBase = (current.dataOffset + current.sizeInWords * current.wordSize + pageSize - 1) / pageSize * pageSize;
+    size_t currentEnd = current.slotOffset + current.blockCount * sizeof(PersistentBlock);
+    size_t slotOffset = (current.blockCount == 0 || slotBase + bytes <= current.slotOffset) ? slotBase : currentEnd;
+
+    if (bytes != 0 && !transferFully(fd, const_cast<PersistentBlock *>(blocks.data()), bytes, slotOffset, true))
+    {
+        return false;
+    }
+    if (fdatasync(fd) != 0)
+    {
+        return false;
+    }
+
+    PersistentArenaHeader header = current;
+    header.generation++;
+    header.slotOffset = slotOffset;
+    header.blockCount = blocks.size();
+    header.slotChecksum = fnv1a(blocks.data(), bytes);
+    header.rootOffset = rootOffset;
+    header.mappedAt = (uint64_t)(uintptr_t)mappedAt;
+    if (!writeHeader(1 - currentCopy, header))
+    {
+        return false;
+    }
+    current = header;
+    currentCopy = 1 - currentCopy;
+    return true;
+}
+
+// Helper function: writes header copy (with its checksum) & makes it durable
+bool PersistentArena::writeHeader(unsigned copy, const PersistentArenaHeader &header)
+{
+    PersistentArenaHeader sealed = header;
+    sealed.headerChecksum = headerChecksum(sealed);
+    return transferFully(fd, &sealed, sizeof(sealed), copy * headerBytes, true) && fdatasync(fd) == 0;
+}
+
+// Helper function: reads header copy, false if it is missing, torn or not an arena of this version
+bool PersistentArena::readHeader(unsigned copy, PersistentArenaHeader &header)
+{
+    return transferFully(fd, &header, sizeof(header), copy * headerBytes, false) && memcmp(header.magic, persistentArenaMagic, sizeof(header.magic)) == 0 &&
+           header.version == persistentArenaVersion && header.headerChecksum == headerChecksum(header);
+}
+
+bool PersistentArena::isOpen() const
+{
+    return fd >= 0;
+}
+
+int PersistentArena::getFd() const
+{
+    return fd;
+}
+
+size_t PersistentArena::getSizeInWords() const
+{
+    return current.sizeInWords;
+}
+
+// Byte offset of the memory block in the file
+size_t PersistentArena::getDataOffset() const
+{
+    return current.dataOffset;
+}
+
+// Address the memory block was mapped at when last synced (nullptr for a new arena)
+void *PersistentArena::getMappedAt() const
+{
+    return (void *)(uintptr_t)current.mappedAt;
+}
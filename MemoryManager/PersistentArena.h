@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Persistent Arena File Format                                                  |
+|     - Two header copies ("MMARENA", version) at bytes 0 & headerBytes, each    |
+|       with its own checksum & generation; the valid copy with the highest      |
+|       generation is current                                                    |
+|     - The memory block itself at dataOffset (page aligned), mapped shared so   |
+|       stores reach the file without copies                                     |
+|     - Header copy k describes metadata slot k after the memory block: one      |
+|       PersistentBlock per allocated block, in ascending offset order (the      |
+|       gaps between them are holes)                                             |
+|     - sync writes the slot & header copy not in use, so a crash at any point   |
+|       leaves the previous sync intact                                          |
+|--------------------------------------------------------------------------------|
+*/
+const char persistentArenaMagic[8] = {'M', 'M', 'A', 'R', 'E', 'N', 'A', '\0'};
+const uint32_t persistentArenaVersion = 1;
+
+struct PersistentBlock
+{
+        uint64_t offset;                              // word offset of the block
+        uint64_t size;                                // words in the block
+        uint64_t handle;                              // handle of a relocatable block, UINT64_MAX for pinned blocks
+};
+
+struct PersistentArenaHeader
+{
+        char magic[8];
+        uint32_t version;
+        uint32_t wordSize;
+        uint64_t sizeInWords;
+        uint64_t dataOffset;                          // byte offset of the memory block in the file
+        uint64_t generation;                          // number of syncs, the highest valid copy is current
+        uint64_t slotOffset;                          // byte offset of this copy's metadata slot
+        uint64_t blockCount;                          // PersistentBlocks in the slot
+        uint64_t slotChecksum;                        // FNV-1a of the slot
+        uint64_t rootOffset;                          // word offset of the root block, UINT64_MAX if none
+        uint64_t mappedAt;                            // address the memory block was mapped at, asked for again on attach
+        uint64_t headerChecksum;                      // FNV-1a of every field above
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  PersistentArena Class Declaration                                             |
+|   - Owns the file behind a MemoryManager attached with attach                  |
+|   - Creates the file on first use, or checks & loads the latest sync of an     |
+|     existing one (the memory block is mapped by ArenaStore, never read here)   |
+|   - Not thread-safe, like the MemoryManager using it                           |
+|--------------------------------------------------------------------------------|
+*/
+class PersistentArena
+{
+ private:
+        static const size_t headerBytes = 512;        // each header copy sits in its own sector
+
+        int fd = -1;
+        PersistentArenaHeader current = {};           // latest valid header copy
+        unsigned currentCopy = 0;                     // index of that copy (0 or 1)
+
+        bool writeHeader(unsigned copy, const PersistentArenaHeader& header);
+        bool readHeader(unsigned copy, PersistentArenaHeader& header);
+
+ public:
+
+        // Constructor / Destructor
+        PersistentArena() = default;
+        ~PersistentArena();
+        PersistentArena(const PersistentArena&) = delete;
+        PersistentArena& operator=(const PersistentArena&) = delete;
+
+        // Opens filename, creating an arena of sizeInWords words if it does not hold one; returns false on error or a wordSize mismatch
+        bool open(const char* filename, unsigned wordSize, size_t sizeInWords);
+        void close();
+
+        // Latest sync: allocated blocks & root (false if its slot is damaged)
+        bool load(std::vector<PersistentBlock>& blocks, uint64_t& rootOffset);
+
+        // Makes blocks & root the latest sync, durably (the memory block must be flushed first)
+        bool save(const std::vector<PersistentBlock>& blocks, uint64_t rootOffset, const void* mappedAt);
+
+        // Get Functions (Accessors)
+        bool isOpen() const;
+        int getFd() const;
+        size_t getSizeInWords() const;
+        size_t getDataOffset() const;
+        void* getMappedAt() const;
+};
@@ -0,0 +1,420 @@
+#include "SharedMemoryManager.h"
+#include "BitmapScan.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Helper function: sets (or clears) the bits of words [offset, offset + size)
+static void setBits(uint64_t *bits, size_t offset, size_t size, bool value)
+{
+    for (size_t word = offset; word < offset + size;)
+    {
+        size_t count = std::min<size_t>(64 - word % 64, offset + size - word);
+        uint64_t mask = (count == 64 ? ~0ULL : ((1ULL << count) - 1)) << (word % 64);
+        bits[word / 64] = value ? (bits[word / 64] | mask) : (bits[word / 64] & ~mask);
+        word += count;
+    }
+}
+
+// Helper function: builds a hole list ([count, offset, size, ...]) of the clear runs of the used bitmap
+template <typename T>
+static T *buildSharedHoleList(const uint64_t *usedBits, size_t sizeInWords)
+{
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t word = 0; word < sizeInWords;)
+    {
+        if (usedBits[word / 64] >> (word % 64) & 1)
+        {
+            word++;
+            continue;
+        }
+        size_t end = word;
+        while (end < sizeInWords && !(usedBits[end / 64] >> (end % 64) & 1))
+        {
+            end++;
+        }
+        runs.push_back({word, end - word});
+        word = end;
+    }
+
+    T *list = new T[1 + 2 * runs.size()];
+    list[0] = (T)runs.size();
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        list[1 + 2 * i] = (T)runs[i].first;
+        list[2 + 2 * i] = (T)runs[i].second;
+    }
+    return list;
+}
+
+
+/*--------------------------------------------|
+|    SharedMemoryManager Class Definitions    |
+|--------------------------------------------*/
+
+/* CONSTRUCTOR:
+Sets the word size, no segment is mapped until initialize or attach
+*/
+SharedMemoryManager::SharedMemoryManager(unsigned wordSize)
+{
+    this->wordSize = wordSize;
+}
+
+/* DESTRUCTOR:
+Unmaps the segment, which stays for the other processes
+*/
+SharedMemoryManager::~SharedMemoryManager()
+{
+    shutdown();
+}
+
+/* INITIALIZER:
+Creates shared memory segment name (e.g. "/buffers") holding a memory block of sizeInWords words, all free, & maps it
+Returns false (nothing mapped) if the segment exists already or could not be created, or its byte size would not fit in a size_t
+*/
+bool SharedMemoryManager::initialize(const char *name, size_t sizeInWords)
+{
+    shutdown();
+    if (sizeInWords == 0 || wordSize == 0 || sizeInWords > SIZE_MAX / 2 / wordSize)   // leaves room for the header & bitmaps
+    {
+        return false;
+    }
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Header, bitmaps, then the memory block on a page boundary
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t bitmapBytes = (sizeInWords + 63) / 64 * sizeof(uint64_t);
+    size_t usedOffset = (sizeof(SharedArenaHeader) + 63) / 64 * 64;
+    size_t headOffset = usedOffset + bitmapBytes;
+    size_t dataOffset = (headOffset + bitmapBytes + pageSize - 1) / pageSize * pageSize;
+    size_t segmentBytes = dataOffset + sizeInWords * wordSize;
+
+    void *segment = MAP_FAILED;
+    if (ftruncate(fd, segmentBytes) == 0)
+    {
+        segment = mmap(nullptr, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (segment == MAP_FAILED)
+    {
+        shm_unlink(name);
+        return false;
+    }
+
+    // ftruncate zero-fills, so both bitmaps start out clear (every word free)
+    header = static_cast<SharedArenaHeader *>(segment);
+    memcpy(header->magic, sharedArenaMagic, sizeof(header->magic));
+    header->version = sharedArenaVersion;
+    header->wordSize = wordSize;
+    header->sizeInWords = sizeInWords;
+    header->usedOffset = usedOffset;
+    header->headOffset = headOffset;
+    header->dataOffset = dataOffset;
+    header->segmentBytes = segmentBytes;
+    header->cursor = 0;
+    header->bytesInUse = 0;
+
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header->lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    usedBits = reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(header) + usedOffset);
+    headBits = reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(header) + headOffset);
+    start = reinterpret_cast<uint8_t *>(header) + dataOffset;
+    memLimit = sizeInWords * wordSize;
+
+    // Processes attaching from here on see a complete segment
+    header->ready.store(1, std::memory_order_release);
+    return true;
+}
+
+/* ATTACH:
+Maps existing shared memory segment name, waiting briefly for its creator to finish setting it up
+Returns false (nothing mapped) if there is no such segment, it is not a memory block of this version, or its word size differs
+*/
+bool SharedMemoryManager::attach(const char *name)
+{
+    shutdown();
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // The creator sizes the segment before writing the header, so wait for both (up to about a second)
+    struct stat status;
+    void *segment = MAP_FAILED;
+    for (int attempt = 0; attempt < 1000; attempt++)
+    {
+        if (fstat(fd, &status) == 0 && (size_t)status.st_size >= sizeof(SharedArenaHeader))
+        {
+            segment = mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            break;
+        }
+        usleep(1000);
+    }
+    close(fd);
+    if (segment == MAP_FAILED)
+    {
+        return false;
+    }
+
+    SharedArenaHeader *mapped = static_cast<SharedArenaHeader *>(segment);
+    for (int attempt = 0; attempt < 1000 && mapped->ready.load(std::memory_order_acquire) == 0; attempt++)
+    {
+        usleep(1000);
+    }
+
+    if (mapped->ready.load(std::memory_order_acquire) == 0 || memcmp(mapped->magic, sharedArenaMagic, sizeof(mapped->magic)) != 0 ||
+        mapped->version != sharedArenaVersion || mapped->wordSize != wordSize || mapped->segmentBytes != (uint64_t)status.st_size)
+    {
+        munmap(segment, status.st_size);
+        return false;
+    }
+
+    header = mapped;
+    usedBits = reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(header) + header->usedOffset);
+    headBits = reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(header) + header->headOffset);
+    start = reinterpret_cast<uint8_t *>(header) + header->dataOffset;
+    memLimit = header->sizeInWords * wordSize;
+    return true;
+}
+
+/* RELEASER:
+Unmaps the segment from this process, if mapped; its blocks stay allocated for the other processes
+*/
+void SharedMemoryManager::shutdown()
+{
+    if (header != nullptr)
+    {
+        munmap(header, header->segmentBytes);
+    }
+    header = nullptr;
+    usedBits = nullptr;
+    headBits = nullptr;
+    start = nullptr;
+    memLimit = 0;
+}
+
+/* DESTROY:
+Removes shared memory segment name; its memory is freed once every process has unmapped it
+*/
+bool SharedMemoryManager::destroy(const char *name)
+{
+    return shm_unlink(name) == 0;
+}
+
+/* ALLOCATOR:
+Allocates a block at the first run of free words at or after the end of the last allocation (by any process), wrapping around once
+If no memory available or invalid size, returns nullptr
+*/
+void *SharedMemoryManager::allocate(size_t sizeInBytes)
+{
+    size_t sizeInWords = (sizeInBytes + wordSize - 1) / wordSize;
+    if (sizeInWords == 0 || header == nullptr)
+    {
+        return nullptr;
+    }
+
+    lock();
+    size_t sizeInSegment = header->sizeInWords;
+    int64_t offset = -1;
+    if (header->cursor < sizeInSegment)
+    {
+        offset = findFreeRun(usedBits, sizeInSegment, sizeInWords, header->cursor);
+    }
+    if (offset == -1)
+    {
+        offset = findFreeRun(usedBits, sizeInSegment, sizeInWords);
+    }
+    if (offset != -1)
+    {
+        // The used bits go first, a process dying before the head bit is set only leaks the words
+        setBits(usedBits, offset, sizeInWords, true);
+        setBits(headBits, offset, 1, true);
+        header->cursor = offset + sizeInWords;
+        header->bytesInUse += sizeInWords * wordSize;
+    }
+    unlock();
+
+    return offset == -1 ? nullptr : (void *)(start + offset * wordSize);
+}
+
+/* DEALLOCATOR:
+Frees the block at address, which any process attached to the segment may have allocated; addresses that are not the start of a block are ignored
+*/
+void SharedMemoryManager::free(void *address)
+{
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+    if (header == nullptr || byteAddress < start || byteAddress >= start + memLimit || (byteAddress - start) % wordSize != 0)
+    {
+        return;
+    }
+
+    size_t offset = (byteAddress - start) / wordSize;
+    lock();
+    if (headBits[offset / 64] >> (offset % 64) & 1)
+    {
+        size_t end = blockEnd(offset);
+        setBits(headBits, offset, 1, false);
+        setBits(usedBits, offset, end - offset, false);
+        header->bytesInUse -= (end - offset) * wordSize;
+    }
+    unlock();
+}
+
+/* TO OFFSET:
+Returns the byte offset of address from the start of the memory block (the same in every process), SIZE_MAX if address is not inside it
+*/
+size_t SharedMemoryManager::toOffset(void *address)
+{
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+    if (start == nullptr || byteAddress < start || byteAddress >= start + memLimit)
+    {
+        return SIZE_MAX;
+    }
+    return byteAddress - start;
+}
+
+/* FROM OFFSET:
+Returns the address of byte offset in this process's mapping, nullptr if offset is past the memory block
+*/
+void *SharedMemoryManager::fromOffset(size_t offset)
+{
+    if (start == nullptr || offset >= memLimit)
+    {
+        return nullptr;
+    }
+    return start + offset;
+}
+
+/* GET LIST:
+Returns the holes as a list in the format MemoryManager's getList uses for HoleListFormat::Auto (uint16_t entries up to 65536 words, uint64_t above)
+Returns nullptr if no segment is mapped; the caller deletes the list with delete[]
+*/
+void *SharedMemoryManager::getList()
+{
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    lock();
+    void *list;
+    if (header->sizeInWords <= 65536)
+    {
+        list = buildSharedHoleList<uint16_t>(usedBits, header->sizeInWords);
+    }
+    else
+    {
+        list = buildSharedHoleList<uint64_t>(usedBits, header->sizeInWords);
+    }
+    unlock();
+    return list;
+}
+
+/* GET BITMAP:
+Returns the used bitmap in MemoryManager's getBitmap format for HoleListFormat::Auto (2-byte little-endian length up to 65536 words, 8-byte above, then one bit per word)
+Returns nullptr if no segment is mapped
+*/
+void *SharedMemoryManager::getBitmap()
+{
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    lock();
+    size_t sizeMap = (header->sizeInWords + 8 - 1) / 8;
+    size_t lengthBytes = header->sizeInWords <= 65536 ? 2 : 8;
+    uint8_t *list = new uint8_t[lengthBytes + sizeMap];
+    for (size_t i = 0; i < lengthBytes; i++)
+    {
+        list[i] = (uint8_t)((sizeMap >> (i * 8)) & 0xFF);
+    }
+    for (size_t i = 0; i < sizeMap; i++)
+    {
+        list[lengthBytes + i] = (uint8_t)(usedBits[i / 8] >> ((i % 8) * 8));
+    }
+    unlock();
+    return list;
+}
+
+unsigned SharedMemoryManager::getWordSize()
+{
+    return wordSize;
+}
+
+void *SharedMemoryManager::getMemoryStart()
+{
+    return start;
+}
+
+size_t SharedMemoryManager::getMemoryLimit()
+{
+    return memLimit;
+}
+
+/* GET BYTES IN USE:
+Returns the bytes in blocks allocated by every process attached to the segment
+*/
+size_t SharedMemoryManager::getBytesInUse()
+{
+    if (header == nullptr)
+    {
+        return 0;
+    }
+    lock();
+    size_t bytesInUse = header->bytesInUse;
+    unlock();
+    return bytesInUse;
+}
+
+// Helper function: takes the segment's lock, taking it over (& marking it consistent) if its holder died
+void SharedMemoryManager::lock()
+{
+    if (pthread_mutex_lock(&header->lock) == EOWNERDEAD)
+    {
+        pthread_mutex_consistent(&header->lock);
+    }
+}
+
+void SharedMemoryManager::unlock()
+{
+    pthread_mutex_unlock(&header->lock);
+}
+
+// Helper function: word offset just past the block starting at offset (the next head or free word, or the end of memory)
+size_t SharedMemoryManager::blockEnd(size_t offset)
+{
+    size_t sizeInWords = header->sizeInWords;
+    size_t word = offset + 1;
+    while (word < sizeInWords)
+    {
+        // Bits of words that end the block: the next head or any free word
+        uint64_t stops = (headBits[word / 64] | ~usedBits[word / 64]) >> (word % 64);
+        if (stops != 0)
+        {
+            return std::min(sizeInWords, word + __builtin_ctzll(stops));
+        }
+        word += 64 - word % 64;
+    }
+    return sizeInWords;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+
+/*
+|--------------------------------------------------------------------------------|
+|  Shared Arena Segment Layout                                                   |
+|     - POSIX shared memory object ("/name", see shm_open) holding a             |
+|       SharedArenaHeader, two bitmaps of one bit per word & the memory block    |
+|     - used bitmap: bit set when the word is allocated                          |
+|       head bitmap: bit set on the first word of each allocated block, so a     |
+|       block runs to the next head or free word                                 |
+|     - Everything is located by offset from the start of the segment, so each   |
+|       process may map it at a different address                                |
+|     - The lock is a robust process-shared mutex: if a process dies holding    |
+|       it, the next process to lock takes it over (the block being allocated    |
+|       or freed by the dead process may leak)                                   |
+|--------------------------------------------------------------------------------|
+*/
+const char sharedArenaMagic[8] = {'M', 'M', 'S', 'H', 'A', 'R', 'E', '\0'};
+const uint32_t sharedArenaVersion = 1;
+
+struct SharedArenaHeader
+{
+        char magic[8];
+        uint32_t version;
+        uint32_t wordSize;
+        uint64_t sizeInWords;
+        uint64_t usedOffset;                          // byte offsets of the bitmaps & memory block in the segment
+        uint64_t headOffset;
+        uint64_t dataOffset;
+        uint64_t segmentBytes;                        // bytes in the whole segment
+        uint64_t cursor;                              // word offset the next search starts from (next fit)
+        uint64_t bytesInUse;                          // bytes in allocated blocks
+        std::atomic<uint32_t> ready;                  // set once the creator has set up the segment
+        pthread_mutex_t lock;                         // guards everything but ready
+};
+
+
+/*
+|--------------------------------------------------------------------------------|
+|  SharedMemoryManager Class Declaration                                         |
+|   - Memory block in a POSIX shared memory segment that every process attached  |
+|     to it can allocate from & free to (a block allocated by one process may be |
+|     freed by another)                                                          |
+|   - Blocks are found with the vectorised bitmap scan (see BitmapScan.h),       |
+|     resuming where the previous allocation in any process ended               |
+|   - Pass blocks between processes as offsets (toOffset / fromOffset), the      |
+|     segment may be mapped at different addresses in each process              |
+|   - Thread-safe: every allocate & free takes the segment's lock               |
+|--------------------------------------------------------------------------------|
+*/
+class SharedMemoryManager
+{
+ private:
+        unsigned wordSize;
+        SharedArenaHeader* header = nullptr;          // start of the mapped segment, nullptr if none
+        uint64_t* usedBits = nullptr;                 // bitmaps inside the segment
+        uint64_t* headBits = nullptr;
+        uint8_t* start = nullptr;                     // pointer to start of memory block
+        size_t memLimit = 0;                          // value representing number of bytes available from start
+
+        void lock();
+        void unlock();
+        size_t blockEnd(size_t offset);
+
+ public:
+
+        // Constructor / Destructor
+        SharedMemoryManager(unsigned wordSize);
+        ~SharedMemoryManager();
+        SharedMemoryManager(const SharedMemoryManager&) = delete;
+        SharedMemoryManager& operator=(const SharedMemoryManager&) = delete;
+
+        // Create / Attach / Detach (not thread-safe with other calls on this object)
+        bool initialize(const char* name, size_t sizeInWords);   // creates segment name, false if it exists already
+        bool attach(const char* name);                // maps existing segment name, false if missing or of another word size
+        void shutdown();                              // unmaps the segment, which lives on until destroy
+        static bool destroy(const char* name);        // removes segment name (processes attached to it keep their mapping)
+
+        // Allocate / Deallocate Sections Of Memory (thread- & process-safe)
+        void* allocate(size_t sizeInBytes);
+        void free(void* address);
+
+        // Offsets (the same block in every process attached to the segment)
+        size_t toOffset(void* address);               // byte offset of address from the memory start, SIZE_MAX if outside it
+        void* fromOffset(size_t offset);              // address of byte offset in this process, nullptr if outside the block
+
+        // Get Functions (Accessors, snapshots taken under the lock)
+        void* getList();
+        void* getBitmap();
+        unsigned getWordSize();
+        void* getMemoryStart();
+        size_t getMemoryLimit();
+        size_t getBytesInUse();
+};
@@ -0,0 +1,229 @@
+#include "SlabAllocator.h"
+
+/*--------------------------------------------|
+|       SlabAllocator Class Definitions       |
+|--------------------------------------------*/
+
+/* CONTSTRUCTOR:
+Attaches to the MemoryManager, so free blocks in slabs are reported as holes
+*/
+SlabAllocator::SlabAllocator(MemoryManager &manager) : manager(manager)
+{
+    manager.attachSubAllocator(this);
+}
+
+/* DESTRUCTOR:
+Gives every slab back to the MemoryManager
+*/
+SlabAllocator::~SlabAllocator()
+{
+    release();
+    manager.detachSubAllocator(this);
+}
+
+/* ALLOCATOR:
+Pops a block of the request's size class (1, 2, 4 or 8 words), larger requests come from the MemoryManager directly
+Returns nullptr if no memory available or invalid size
+*/
+void *SlabAllocator::allocate(size_t sizeInBytes)
+{
+    unsigned wordSize = manager.getWordSize();
+    size_t sizeInWords = (sizeInBytes + wordSize - 1) / wordSize;
+
+    if (sizeInWords == 0)
+    {
+        return nullptr;
+    }
+    if (sizeInWords > maxSlabWords)
+    {
+        return manager.allocate(sizeInBytes);
+    }
+
+    unsigned sizeClass = sizeInWords <= 1 ? 0 : 64 - __builtin_clzll(sizeInWords - 1);
+    Slab *slab = partialSlabs[sizeClass];
+
+    if (slab == nullptr)
+    {
+        slab = emptySlab[sizeClass] ? emptySlab[sizeClass] : newSlab(sizeClass);
+        if (slab == nullptr)
+        {
+            return nullptr;
+        }
+        emptySlab[sizeClass] = nullptr;
+        linkPartial(slab);
+    }
+
+    // Pop the lowest free block
+    unsigned block = __builtin_ctzll(slab->freeMask);
+    slab->freeMask &= slab->freeMask - 1;
+    if (slab->freeMask == 0)
+    {
+        unlinkPartial(slab);
+    }
+
+    size_t offset = slab->offset + ((size_t)block << slab->sizeClass);
+    return static_cast<uint8_t *>(manager.getMemoryStart()) + offset * wordSize;
+}
+
+/* DEALLOCATOR:
+Pushes the block back onto its slab; addresses outside any slab are passed through to the MemoryManager
+*/
+void SlabAllocator::free(void *address)
+{
+    uint8_t *start = static_cast<uint8_t *>(manager.getMemoryStart());
+    uint8_t *byteAddress = static_cast<uint8_t *>(address);
+    unsigned wordSize = manager.getWordSize();
+
+    if (start == nullptr || byteAddress < start)
+    {
+        return;
+    }
+
+    // Find the slab starting at or before the address
+    size_t offset = (byteAddress - start) / wordSize;
+    auto iter = slabs.upper_bound(offset);
+    Slab *slab = nullptr;
+    if (iter != slabs.begin())
+    {
+        slab = std::prev(iter)->second.get();
+    }
+
+    size_t blockWords = slab ? (size_t(1) << slab->sizeClass) : 0;
+    if (slab == nullptr || offset >= slab->offset + blockWords * blocksPerSlab)
+    {
+        manager.free(address);
+        return;
+    }
+
+    // Ignore addresses that are not the start of an allocated block
+    size_t block = (offset - slab->offset) >> slab->sizeClass;
+    if ((byteAddress - start) % wordSize != 0 || (offset - slab->offset) % blockWords != 0 || (slab->freeMask >> block) & 1)
+    {
+        return;
+    }
+
+    if (slab->freeMask == 0)
+    {
+        linkPartial(slab);
+    }
+    slab->freeMask |= 1ULL << block;
+
+    // Whole slab free: keep it as the class's spare, or give it back if there already is one
+    if (slab->freeMask == ~0ULL)
+    {
+        unlinkPartial(slab);
+        if (emptySlab[slab->sizeClass] == nullptr)
+        {
+            emptySlab[slab->sizeClass] = slab;
+        }
+        else
+        {
+            releaseSlab(slab);
+        }
+    }
+}
+
+/* RELEASER:
+Gives every slab (including any blocks still allocated from them) back to the MemoryManager
+*/
+void SlabAllocator::release()
+{
+    for (auto &entry : slabs)
+    {
+        manager.free(static_cast<uint8_t *>(manager.getMemoryStart()) + entry.first * manager.getWordSize());
+    }
+    slabs.clear();
+    std::fill(std::begin(partialSlabs), std::end(partialSlabs), nullptr);
+    std::fill(std::begin(emptySlab), std::end(emptySlab), nullptr);
+}
+
+/* GET SLAB COUNT:
+Returns number of slabs currently held from the MemoryManager
+*/
+size_t SlabAllocator::getSlabCount() const
+{
+    return slabs.size();
+}
+
+/* FOR EACH FREE RANGE:
+Reports runs of free blocks inside slabs, in ascending word offset order
+*/
+void SlabAllocator::forEachFreeRange(const std::function<void(size_t offset, size_t size)> &visit) const
+{
+    for (auto &entry : slabs)
+    {
+        const Slab &slab = *entry.second;
+        uint64_t mask = slab.freeMask;
+
+        while (mask != 0)
+        {
+            unsigned first = __builtin_ctzll(mask);
+            uint64_t shifted = mask >> first;
+            unsigned length = (~shifted == 0) ? 64 : __builtin_ctzll(~shifted);
+
+            visit(slab.offset + ((size_t)first << slab.sizeClass), (size_t)length << slab.sizeClass);
+
+            if (first + length >= 64)
+            {
+                break;
+            }
+            mask &= ~0ULL << (first + length);
+        }
+    }
+}
+
+// Helper function: carves a new slab of the class out of the MemoryManager (outside any region, the slab outlives it)
+SlabAllocator::Slab *SlabAllocator::newSlab(unsigned sizeClass)
+{
+    unsigned wordSize = manager.getWordSize();
+    uint8_t *chunk = static_cast<uint8_t *>(manager.allocateOutsideRegion(((size_t)blocksPerSlab << sizeClass) * wordSize));
+    if (chunk == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<Slab> slab(new Slab());
+    slab->offset = (chunk - static_cast<uint8_t *>(manager.getMemoryStart())) / wordSize;
+    slab->sizeClass = sizeClass;
+
+    Slab *created = slab.get();
+    slabs[created->offset] = std::move(slab);
+    return created;
+}
+
+// Helper function: gives a slab's chunk back to the MemoryManager
+void SlabAllocator::releaseSlab(Slab *slab)
+{
+    size_t offset = slab->offset;
+    manager.free(static_cast<uint8_t *>(manager.getMemoryStart()) + offset * manager.getWordSize());
+    slabs.erase(offset);
+}
+
+// Helper functions: maintain the lists of slabs with free blocks
+void SlabAllocator::linkPartial(Slab *slab)
+{
+    slab->prevPartial = nullptr;
+    slab->nextPartial = partialSlabs[slab->sizeClass];
+    if (slab->nextPartial)
+    {
+        slab->nextPartial->prevPartial = slab;
+    }
+    partialSlabs[slab->sizeClass] = slab;
+}
+
+void SlabAllocator::unlinkPartial(Slab *slab)
+{
+    if (slab->prevPartial)
+    {
+        slab->prevPartial->nextPartial = slab->nextPartial;
+    }
+    else
+    {
+        partialSlabs[slab->sizeClass] = slab->nextPartial;
+    }
+    if (slab->nextPartial)
+    {
+        slab->nextPartial->prevPartial = slab->prevPartial;
+    }
+    slab->prevPartial = slab->nextPartial = nullptr;
+}
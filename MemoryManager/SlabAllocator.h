@@ -0,0 +1,69 @@
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "MemoryManager.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  SlabAllocator Class Declaration                                               |
+|   - Front-end for small fixed-size requests on top of a MemoryManager          |
+|   - Size classes of 1, 2, 4 and 8 words, each served from slabs of 64 blocks   |
+|     carved out of one MemoryManager::allocate chunk                            |
+|   - A slab's free blocks are a 64-bit mask, so pop / push are a ctz / bit set  |
+|   - A slab is given back to the MemoryManager once all its blocks are free     |
+|     (one empty slab per class is kept, so a block bouncing at a slab boundary  |
+|     does not allocate & free a whole slab each time)                           |
+|   - Free blocks inside slabs are reported through SubAllocator, so getList /   |
+|     getBitmap of the MemoryManager still show them as holes                    |
+|   - Larger requests are passed through to the MemoryManager                    |
+|   - Slabs are carved with allocateOutsideRegion, so popRegion never frees a    |
+|     slab that still hands out blocks                                           |
+|   - Must be destroyed (or release()d) before the MemoryManager shuts down      |
+|--------------------------------------------------------------------------------|
+*/
+class SlabAllocator : public SubAllocator
+{
+ public:
+        static const unsigned classCount = 4;                 // size classes of 1, 2, 4 & 8 words
+        static const unsigned blocksPerSlab = 64;             // one bit of freeMask per block
+        static const size_t maxSlabWords = size_t(1) << (classCount - 1);
+
+ private:
+        struct Slab
+        {
+                size_t offset;                                // word offset of the slab's chunk in the MemoryManager
+                uint64_t freeMask = ~0ULL;                    // bit b set when block b is free
+                unsigned sizeClass;                           // blocks are 2^sizeClass words
+                Slab* prevPartial = nullptr;                  // neighbours in the class's list of slabs with free blocks
+                Slab* nextPartial = nullptr;
+        };
+
+        MemoryManager& manager;
+        std::map<size_t, std::unique_ptr<Slab>> slabs;        // every slab, by word offset (routes free to its slab)
+        Slab* partialSlabs[classCount] = {};                  // slabs of each class with at least one free block
+        Slab* emptySlab[classCount] = {};                     // one fully free slab kept per class
+
+        Slab* newSlab(unsigned sizeClass);
+        void releaseSlab(Slab* slab);
+        void linkPartial(Slab* slab);
+        void unlinkPartial(Slab* slab);
+
+ public:
+
+        // Constructor / Destructor
+        SlabAllocator(MemoryManager& manager);
+        ~SlabAllocator();
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+        // Allocate / Deallocate Sections Of Memory
+        void* allocate(size_t sizeInBytes);
+        void free(void* address);
+        void release();
+
+        // Get Functions (Accessors)
+        size_t getSlabCount() const;
+        void forEachFreeRange(const std::function<void(size_t offset, size_t size)>& visit) const override;
+};
@@ -0,0 +1,315 @@
+#include <cstring>
+
+#include "TlsfEngine.h"
+
+/*--------------------------------------------|
+|        TlsfEngine Class Definitions         |
+|--------------------------------------------*/
+
+/* CONTSTRUCTOR:
+Starts out with the whole memory block as one free block
+*/
+TlsfEngine::TlsfEngine(uint8_t *base, unsigned wordSize, size_t sizeInWords) : base(base), wordSize(wordSize), sizeInWords(sizeInWords)
+{
+    minBlock = (minBlockBytes + wordSize - 1) / wordSize;
+    tags.assign(sizeInWords, 0);
+
+    for (unsigned fl = 0; fl < flCount; fl++)
+    {
+        for (unsigned sl = 0; sl < slCount; sl++)
+        {
+            heads[fl][sl] = noBlock;
+        }
+    }
+
+    writeTags(0, sizeInWords, true);
+
+    // A memory block too short for the links is reported as a hole but never handed out
+    if (sizeInWords >= minBlock)
+    {
+        insertFree(0, sizeInWords);
+    }
+}
+
+/* ALLOCATOR:
+Takes the first block of the smallest non-empty list whose blocks all fit, splitting off the unused tail as a new free block
+Returns -1 if no free block is large enough
+*/
+int64_t TlsfEngine::allocate(size_t sizeInWords)
+{
+    if (sizeInWords == 0 || sizeInWords > this->sizeInWords)
+    {
+        return -1;
+    }
+
+    size_t request = sizeInWords < minBlock ? minBlock : sizeInWords;
+    unsigned fl, sl;
+    int64_t offset = findFree(request, fl, sl);
+    if (offset == -1)
+    {
+        return -1;
+    }
+
+    size_t size = tags[offset] >> 2;
+    removeFree(offset, size);
+
+    // Tails too short to hold the free list links stay part of the block
+    if (size - request >= minBlock)
+    {
+        writeTags(offset + request, size - request, true);
+        insertFree(offset + request, size - request);
+        size = request;
+    }
+
+    writeTags(offset, size, false);
+    return offset;
+}
+
+/* ALIGNED ALLOCATOR:
+Takes a free block with room for the request past the first suitable offset, the words before that offset become a free block of their own
+Returns -1 if no free block is large enough
+*/
+int64_t TlsfEngine::allocateAligned(size_t sizeInWords, size_t alignInWords, size_t phase)
+{
+    if (alignInWords <= 1)
+    {
+        return allocate(sizeInWords);
+    }
+    if (sizeInWords == 0 || sizeInWords > this->sizeInWords)
+    {
+        return -1;
+    }
+
+    // A lead of 1 to minBlock - 1 words cannot be a free block, so the worst case skips ahead by almost alignInWords + minBlock words
+    size_t request = sizeInWords < minBlock ? minBlock : sizeInWords;
+    size_t search = request + alignInWords + minBlock - 1;
+    if (search > this->sizeInWords)
+    {
+        return -1;
+    }
+
+    unsigned fl, sl;
+    int64_t offset = findFree(search, fl, sl);
+    if (offset == -1)
+    {
+        return -1;
+    }
+
+    size_t size = tags[offset] >> 2;
+    removeFree(offset, size);
+
+    size_t aligned = offset + ((phase - offset) & (alignInWords - 1));
+    while (aligned != (size_t)offset && aligned - offset < minBlock)
+    {
+        aligned += alignInWords;
+    }
+    if (aligned != (size_t)offset)
+    {
+        writeTags(offset, aligned - offset, true);
+        insertFree(offset, aligned - offset);
+        size -= aligned - offset;
+    }
+
+    // Tails too short to hold the free list links stay part of the block
+    if (size - request >= minBlock)
+    {
+        writeTags(aligned + request, size - request, true);
+        insertFree(aligned + request, size - request);
+        size = request;
+    }
+
+    writeTags(aligned, size, false);
+    return (int64_t)aligned;
+}
+
+/* DEALLOCATOR:
+Frees the block at offset, merging it with a free block before and/or after it
+*/
+size_t TlsfEngine::free(size_t offset)
+{
+    if (offset >= sizeInWords || (tags[offset] & (headTag | freeTag)) != headTag)
+    {
+        return 0;
+    }
+
+    size_t size = tags[offset] >> 2;
+    size_t released = size;
+
+    // The last word of the block before tells its size & whether it is free
+    if (offset > 0 && (tags[offset - 1] & freeTag))
+    {
+        size_t prevSize = tags[offset - 1] >> 2;
+        removeFree(offset - prevSize, prevSize);
+        tags[offset - 1] = 0;
+        tags[offset] = 0;
+        offset -= prevSize;
+        size += prevSize;
+    }
+
+    size_t next = offset + size;
+    if (next < sizeInWords && (tags[next] & freeTag))
+    {
+        size_t nextSize = tags[next] >> 2;
+        removeFree(next, nextSize);
+        tags[next - 1] = 0;
+        tags[next] = 0;
+        size += nextSize;
+    }
+
+    writeTags(offset, size, true);
+    insertFree(offset, size);
+    return released;
+}
+
+/* GET BLOCK SIZE:
+Returns the size in words of the allocated block at offset (0 if there is none)
+*/
+size_t TlsfEngine::blockSize(size_t offset) const
+{
+    if (offset >= sizeInWords || (tags[offset] & (headTag | freeTag)) != headTag)
+    {
+        return 0;
+    }
+    return tags[offset] >> 2;
+}
+
+/* FOR EACH HOLE:
+Visits every free block in offset order, walking the blocks by their tags
+*/
+void TlsfEngine::forEachHole(const std::function<void(size_t offset, size_t size)> &visit) const
+{
+    size_t offset = 0;
+    while (offset < sizeInWords)
+    {
+        size_t size = tags[offset] >> 2;
+        if (tags[offset] & freeTag)
+        {
+            visit(offset, size);
+        }
+        offset += size;
+    }
+}
+
+// Helper function: list (first level, second level) holding free blocks of the given size
+void TlsfEngine::mapping(size_t size, unsigned &fl, unsigned &sl)
+{
+    if (size < slCount)
+    {
+        fl = 0;
+        sl = (unsigned)size;
+        return;
+    }
+
+    unsigned log2 = 63 - __builtin_clzll(size);
+    fl = log2 - (slLog2 - 1);
+    sl = (unsigned)(size >> (log2 - slLog2)) & (slCount - 1);
+}
+
+// Helper function: offset of a free block of at least sizeInWords words (-1 if none), with the list it is in
+int64_t TlsfEngine::findFree(size_t sizeInWords, unsigned &fl, unsigned &sl)
+{
+    // Round up to the next list boundary, so every block of the list found is large enough
+    size_t rounded = sizeInWords;
+    if (sizeInWords >= slCount)
+    {
+        rounded += ((size_t)1 << (63 - __builtin_clzll(sizeInWords) - slLog2)) - 1;
+    }
+    mapping(rounded, fl, sl);
+
+    if (fl < flCount)
+    {
+        uint32_t slBits = slBitmap[fl] & (~0u << sl);
+        if (slBits == 0)
+        {
+            uint32_t flBits = flBitmap & (~0u << (fl + 1));
+            fl = flBits ? __builtin_ctz(flBits) : flCount;
+            slBits = fl < flCount ? slBitmap[fl] : 0;
+        }
+        if (slBits)
+        {
+            sl = __builtin_ctz(slBits);
+            return heads[fl][sl];
+        }
+    }
+
+    // Only the request's own list is left unchecked; its first block is tried (e.g. the whole memory block), walking the rest would not be O(1)
+    mapping(sizeInWords, fl, sl);
+    uint32_t offset = heads[fl][sl];
+    if (offset != noBlock && (tags[offset] >> 2) >= sizeInWords)
+    {
+        return offset;
+    }
+    return -1;
+}
+
+// Helper function: writes the boundary tags of a block (its last word first, the first word wins for one word blocks)
+void TlsfEngine::writeTags(size_t offset, size_t size, bool isFree)
+{
+    uint32_t tag = (uint32_t)(size << 2) | (isFree ? freeTag : 0);
+    tags[offset + size - 1] = tag;
+    tags[offset] = tag | headTag;
+}
+
+// Helper function: pushes a free block onto the front of its list
+void TlsfEngine::insertFree(size_t offset, size_t size)
+{
+    unsigned fl, sl;
+    mapping(size, fl, sl);
+
+    uint32_t next = heads[fl][sl];
+    setLink(offset, 0, next);
+    setLink(offset, 1, noBlock);
+    if (next != noBlock)
+    {
+        setLink(next, 1, (uint32_t)offset);
+    }
+
+    heads[fl][sl] = (uint32_t)offset;
+    flBitmap |= 1u << fl;
+    slBitmap[fl] |= 1u << sl;
+}
+
+// Helper function: unlinks a free block from its list
+void TlsfEngine::removeFree(size_t offset, size_t size)
+{
+    unsigned fl, sl;
+    mapping(size, fl, sl);
+
+    uint32_t next = getLink(offset, 0);
+    uint32_t prev = getLink(offset, 1);
+    if (next != noBlock)
+    {
+        setLink(next, 1, prev);
+    }
+    if (prev != noBlock)
+    {
+        setLink(prev, 0, next);
+    }
+    else
+    {
+        heads[fl][sl] = next;
+    }
+
+    if (heads[fl][sl] == noBlock)
+    {
+        slBitmap[fl] &= ~(1u << sl);
+        if (slBitmap[fl] == 0)
+        {
+            flBitmap &= ~(1u << fl);
+        }
+    }
+}
+
+// Helper function: reads link 0 (next) or 1 (prev) from a free block's memory (memcpy, words need not be 4 byte aligned)
+uint32_t TlsfEngine::getLink(size_t offset, unsigned which) const
+{
+    uint32_t value;
+    memcpy(&value, base + offset * wordSize + which * sizeof(uint32_t), sizeof(uint32_t));
+    return value;
+}
+
+// Helper function: writes link 0 (next) or 1 (prev) into a free block's memory
+void TlsfEngine::setLink(size_t offset, unsigned which, uint32_t value)
+{
+    memcpy(base + offset * wordSize + which * sizeof(uint32_t), &value, sizeof(uint32_t));
+}
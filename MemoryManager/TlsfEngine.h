@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "AllocatorEngine.h"
+
+/*
+|--------------------------------------------------------------------------------|
+|  TlsfEngine Class Declaration                                                  |
+|   - Two-level segregated fit: free blocks are kept in lists by size class,     |
+|     first level = power of two, second level = one of slCount equal steps      |
+|   - One bit per first level & per list says which lists are non-empty, so a    |
+|     list holding a large enough block is found with two find-first-set ops     |
+|   - Requests are rounded up to the next list, so of the blocks in their own    |
+|     list only the first is tried: a request may fail while a block that fits   |
+|     sits deeper in that list (the price of O(1))                               |
+|   - Every block has a boundary tag at its first & last word (kept in a shadow  |
+|     array, not in the memory block), so free merges with both neighbours in    |
+|     O(1); the array takes 4 bytes per word of memory, half as much again as    |
+|     the memory block at wordSize 8 (as much again at wordSize 4)               |
+|   - Free list links live in the free block's own memory, so a block is at      |
+|     least minBlockBytes long                                                   |
+|--------------------------------------------------------------------------------|
+*/
+class TlsfEngine : public AllocatorEngine
+{
+ public:
+        static const unsigned slLog2 = 4;                             // log2 of the number of second level lists per first level
+        static const unsigned slCount = 1u << slLog2;
+        static const unsigned flCount = 27;                           // first level 0 holds sizes below slCount, level f holds [2^(f+3), 2^(f+4))
+        static const size_t maxWords = ((size_t)1 << 30) - 1;         // largest memory block (sizes share a 32-bit tag with two flag bits)
+        static const size_t minBlockBytes = 2 * sizeof(uint32_t);     // room for the free list links
+
+ private:
+        static const uint32_t noBlock = UINT32_MAX;                   // end of a free list
+        static const uint32_t freeTag = 1;                            // tag bit: block is free
+        static const uint32_t headTag = 2;                            // tag bit: tag is at the block's first word (not just its last)
+
+        uint8_t* base;                                                // first byte of the memory block (holds the free list links)
+        unsigned wordSize;
+        size_t sizeInWords;                                           // words managed, from offset 0
+        size_t minBlock;                                              // fewest words in a block
+
+        uint32_t flBitmap = 0;                                        // bit f set if any list of first level f is non-empty
+        uint32_t slBitmap[flCount] = {};                              // bit s of slBitmap[f] set if heads[f][s] is non-empty
+        uint32_t heads[flCount][slCount];                             // first free block of each list
+        std::vector<uint32_t> tags;                                   // per word: size << 2 | headTag | freeTag at a block's first & last word, 0 elsewhere
+
+ public:
+
+        // Constructor (sizeInWords must be at most maxWords)
+        TlsfEngine(uint8_t* base, unsigned wordSize, size_t sizeInWords);
+
+        // AllocatorEngine
+        int64_t allocate(size_t sizeInWords) override;
+        int64_t allocateAligned(size_t sizeInWords, size_t alignInWords, size_t phase) override;
+        size_t free(size_t offset) override;
+        size_t blockSize(size_t offset) const override;
+        void forEachHole(const std::function<void(size_t offset, size_t size)>& visit) const override;
+
+ private:
+        static void mapping(size_t size, unsigned& fl, unsigned& sl);
+        int64_t findFree(size_t sizeInWords, unsigned& fl, unsigned& sl);
+        void writeTags(size_t offset, size_t size, bool isFree);
+        void insertFree(size_t offset, size_t size);
+        void removeFree(size_t offset, size_t size);
+        uint32_t getLink(size_t offset, unsigned which) const;
+        void setLink(size_t offset, unsigned which, uint32_t value);
+};